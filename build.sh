@@ -174,6 +174,7 @@ include doc/*
 include README
 include test_more.py
 include test_example.py
+include test_speed.py
 EOF
 echo "./setup.py sdist > setup.log"
 ./setup.py sdist > $log_dir/setup.log
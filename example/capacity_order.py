@@ -0,0 +1,49 @@
+# $begin capacity_order.py$$ $newlinech #$$
+# $spell
+# $$
+#
+# $section Taylor Coefficient Capacity: Example and Test$$
+#
+# $index capacity_order, example$$
+# $index example, capacity_order$$
+#
+# $code
+# $verbatim%example/capacity_order.py%0%# BEGIN CODE%# END CODE%1%$$
+# $$
+# $end
+# BEGIN CODE
+from pycppad import *
+def pycppad_test_capacity_order():
+  x   = numpy.array( [ 1., 2. ] )
+  a_x = independent(x)
+  a_y = numpy.array( [ a_x[0] * exp( a_x[1] ) ] )
+  f   = adfun(a_x, a_y)
+  #
+  # store orders zero, one and two
+  f.forward(0, x)
+  f.forward(1, numpy.array( [ 1., 0. ] ) )
+  f.forward(2, numpy.array( [ 0., 0. ] ) )
+  three = f.memory()['taylor_bytes']
+  # keep only order zero, so reverse mode for first order still works
+  f.capacity_order(1)
+  assert 3 * f.memory()['taylor_bytes'] == three
+  dw  = f.reverse(1, numpy.array( [ 1. ] ) )
+  assert abs( dw[0] - exp( x[1] ) ) < 1e-10
+  # drop all the Taylor coefficients
+  f.capacity_order(0)
+  assert f.memory()['taylor_bytes'] == 0
+  #
+  # drop the Taylor coefficients after each derivative driver
+  f.capacity_policy(True, 1)
+  J   = f.jacobian(x)
+  assert abs( J[0, 1] - x[0] * exp( x[1] ) ) < 1e-10
+  assert f.memory()['taylor_bytes'] == 0
+  #
+  # reserve three orders before each zero order forward
+  f.capacity_policy(False, 3)
+  f.forward(0, x)
+  f.forward(1, numpy.array( [ 1., 0. ] ) )
+  assert f.stats()['size_order'] == 2
+  # the capacity for three orders is allocated
+  assert f.memory()['taylor_bytes'] == three
+# END CODE
@@ -43,6 +43,18 @@ def pycppad_test_condexp() :
   assert ( y[2] == 1. )  # 4 == 3 is false so result is 1
   assert ( y[3] == 2. )  # 4 >= 3 is true  so result is 2
   assert ( y[4] == 2. )  # 4 >  3 is true  so result is 2
+# Example using arrays -----------------------------------------------------
+def pycppad_test_condexp_array() :
+  x          = numpy.array( [ -2. , -1. , 1., 2. ] )
+  a_x        = independent(x)
+  # relu(x) = max(x, 0) for every element of x
+  a_y        = condexp_gt(a_x, 0., a_x, 0.)
+  f          = adfun(a_x, a_y)
+  y          = f.forward(0, x)
+  assert numpy.all( y == numpy.array( [ 0., 0., 1., 2. ] ) )
+  # the same function for other signs of x (no new recording required)
+  y          = f.forward(0, -x)
+  assert numpy.all( y == numpy.array( [ 2., 1., 0., 0. ] ) )
 # Example using a2float ----------------------------------------------------
 def pycppad_test_condexp_a2() :
   x          = numpy.array( [1. , 1., 3., 4. ] )
@@ -0,0 +1,48 @@
+# $begin counters.py$$ $newlinech #$$
+# $spell
+# $$
+#
+# $section Instrumentation Counters: Example and Test$$
+#
+# $index counters, example$$
+# $index example, counters$$
+#
+# $code
+# $verbatim%example/counters.py%0%# BEGIN CODE%# END CODE%1%$$
+# $$
+# $end
+# BEGIN CODE
+from pycppad import *
+def pycppad_test_counters():
+  x   = numpy.array( [ 1., 2., 3. ] )
+  a_x = independent(x)
+  a_y = numpy.array( [ a_x[0] * a_x[1] * a_x[2] ] )
+  f   = adfun(a_x, a_y)
+  f.reset_counters()
+  reset_counters()
+  #
+  f.forward(0, x)
+  f.forward(1, numpy.array( [ 1., 0., 0. ] ) )
+  f.reverse(1, numpy.array( [ 1. ] ) )
+  J   = f.jacobian(x)
+  assert J.shape == (1, 3)
+  c   = f.counters()
+  if not c['enabled'] :
+    # pycppad was not compiled with instrumentation
+    assert c == { 'enabled' : False }
+    assert counters() == c
+    return
+  assert c['call'] == 4
+  # the jacobian uses one order zero forward sweep and one reverse
+  # sweep for each range component (because m < n)
+  assert c['forward'] == [ 2 , 1 ]
+  assert c['reverse'] == [ 2 ]
+  assert c['bytes'] > 0
+  assert c['convert_us'] >= 0 and c['sweep_us'] >= 0
+  # the global counters include all the adfun objects
+  g   = counters()
+  assert g['call'] == c['call']
+  f.reset_counters()
+  assert f.counters()['call'] == 0
+  assert counters()['call'] == g['call']
+# END CODE
@@ -0,0 +1,63 @@
+# $begin derivative_adfun.py$$ $newlinech #$$
+# $spell
+#	adfun
+#	jacobian
+# $$
+#
+# $section Derivative Function Object: Example and Test$$
+#
+# $index derivative_adfun, example$$
+# $index example, derivative_adfun$$
+#
+# $code
+# $verbatim%example/derivative_adfun.py%0%# BEGIN CODE%# END CODE%1%$$
+# $$
+# $end
+# BEGIN CODE
+from pycppad import *
+# Example using a_float -----------------------------------------------------
+def pycppad_test_derivative_adfun():
+  delta = 10. * numpy.finfo(float).eps
+  x     = numpy.array( [ 0., 0. ] )
+  a_x   = independent(x)
+  a_y   = numpy.array( [ a_x[0] * sin(a_x[1]) ] )
+  f     = adfun(a_x, a_y)
+  x     = numpy.array( [ 2., 3. ] )
+  # gradient
+  g     = f.derivative_adfun('gradient')
+  y     = g.forward(0, x)
+  assert abs( y[0] - sin(x[1]) )        < delta
+  assert abs( y[1] - x[0] * cos(x[1]) ) < delta
+  # the Jacobian of the gradient is the Hessian
+  H     = g.jacobian(x)
+  check = f.hessian(x, numpy.array( [ 1. ] ) )
+  for i in range(2) :
+    for j in range(2) :
+      assert abs( H[i,j] - check[i,j] ) < delta
+  # Jacobian in row major order
+  J     = f.derivative_adfun('jacobian')
+  y     = J.forward(0, x)
+  check = f.jacobian(x)
+  assert y.shape == (2,)
+  for j in range(2) :
+    assert abs( y[j] - check[0,j] ) < delta
+  # Hessian times a vector; the argument is x followed by v
+  h     = f.derivative_adfun('hessian_vector')
+  v     = numpy.array( [ 1., 2. ] )
+  y     = h.forward(0, numpy.concatenate( (x, v) ) )
+  check = numpy.dot(H, v)
+  for j in range(2) :
+    assert abs( y[j] - check[j] ) < delta
+# Example using a2float -----------------------------------------------------
+def pycppad_test_derivative_adfun_a2():
+  delta = 10. * numpy.finfo(float).eps
+  a_x   = ad( numpy.array( [ 0., 0. ] ) )
+  a2x   = independent(a_x)
+  a2y   = numpy.array( [ a2x[0] * a2x[0] * a2x[1] ] )
+  a_f   = adfun(a2x, a2y)
+  a_g   = a_f.derivative_adfun('gradient')
+  x     = numpy.array( [ 2., 3. ] )
+  a_y   = a_g.forward(0, ad(x) )
+  assert abs( a_y[0] - 2. * x[0] * x[1] ) < delta
+  assert abs( a_y[1] - x[0] * x[0] )      < delta
+# END CODE
@@ -0,0 +1,41 @@
+# $begin forward_points.py$$ $newlinech #$$
+# $spell
+# $$
+#
+# $section Function Values at Many Points: Example and Test$$
+#
+# $index forward_points, example$$
+# $index example, forward_points$$
+#
+# $code
+# $verbatim%example/forward_points.py%0%# BEGIN CODE%# END CODE%1%$$
+# $$
+# $end
+# BEGIN CODE
+from pycppad import *
+def pycppad_test_forward_points():
+  # y = [ max(x0, x1) , x0 * x1 ]
+  x   = numpy.array( [ 0., 0. ] )
+  a_x = independent(x)
+  a_m = condexp_gt(a_x[0], a_x[1], a_x[0], a_x[1])
+  a_y = numpy.array( [ a_m , a_x[0] * a_x[1] ] )
+  f   = adfun(a_x, a_y)
+  #
+  k   = 5
+  X   = numpy.array( [ [ 1. * i, 2. ] for i in range(k) ] )
+  Y   = f.forward_points(X)
+  assert Y.shape == (k, 2)
+  for i in range(k) :
+    assert Y[i, 0] == max(X[i, 0], X[i, 1])
+    assert Y[i, 1] == X[i, 0] * X[i, 1]
+  #
+  # the zero order Taylor coefficients correspond to the last point
+  dy  = f.forward(1, numpy.array( [ 1., 0. ] ) )
+  assert dy[0] == 1.
+  assert dy[1] == X[k-1, 1]
+  #
+  # single precision points are converted to double precision
+  Y   = f.forward_points( numpy.array(X, dtype=numpy.float32) )
+  assert Y.dtype == float
+  assert Y[1, 1] == 2.
+# END CODE
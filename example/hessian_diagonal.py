@@ -0,0 +1,55 @@
+# $begin hessian_diagonal.py$$ $newlinech #$$
+# $spell
+#	Hessian
+# $$
+#
+# $section Diagonal of Hessian: Example and Test$$
+#
+# $index hessian_diagonal, example$$
+# $index example, hessian_diagonal$$
+#
+# $code
+# $verbatim%example/hessian_diagonal.py%0%# BEGIN CODE%# END CODE%1%$$
+# $$
+# $end
+# BEGIN CODE
+from pycppad import *
+# Example using a_float -----------------------------------------------------
+def pycppad_test_hessian_diagonal():
+  delta = 10. * numpy.finfo(float).eps
+  n     = 5
+  x     = numpy.array( n * [ 0. ] )
+  a_x   = independent(x)
+  # F_0 (x) = sum_j sin(x_j) (Hessian is diagonal)
+  # F_1 (x) = x_0 * x_1 * x_2  (Hessian has off diagonal elements)
+  a_sum = 0.
+  for j in range(n) :
+    a_sum = a_sum + sin( a_x[j] )
+  a_y = numpy.array( [ a_sum , a_x[0] * a_x[1] * a_x[2] ] )
+  f   = adfun(a_x, a_y)
+  x   = numpy.array( [ 1., 2., 3., 4., 5. ] )
+  w   = numpy.array( [ 2., 3. ] )
+  d   = f.hessian_diagonal(x, w)
+  H   = f.hessian(x, w)
+  for j in range(n) :
+    assert abs( d[j] - H[j,j] ) < delta
+    assert abs( d[j] + w[0] * sin(x[j]) ) < delta
+  # second call uses the same coloring at a different point
+  x   = numpy.array( [ 5., 4., 3., 2., 1. ] )
+  d   = f.hessian_diagonal(x, w)
+  for j in range(n) :
+    assert abs( d[j] + w[0] * sin(x[j]) ) < delta
+# Example using a2float -----------------------------------------------------
+def pycppad_test_hessian_diagonal_a2():
+  delta = 10. * numpy.finfo(float).eps
+  a_x   = ad( numpy.array( [ 0., 0. ] ) )
+  a2x   = independent(a_x)
+  a2y   = numpy.array( [ a2x[0] * a2x[0] * sin(a2x[1]) ] )
+  a_f   = adfun(a2x, a2y)
+  x     = numpy.array( [ 2., 3. ] )
+  a_x   = ad(x)
+  a_w   = ad( numpy.array( [ 1. ] ) )
+  a_d   = a_f.hessian_diagonal(a_x, a_w)
+  assert abs( a_d[0] - 2. * sin(x[1])               ) < delta
+  assert abs( a_d[1] + x[0] * x[0] * sin(x[1])      ) < delta
+# END CODE
@@ -0,0 +1,60 @@
+# $begin hessian_vector.py$$ $newlinech #$$
+# $spell
+#	Hessian
+# $$
+#
+# $section Hessian Times Vector: Example and Test$$
+#
+# $index hessian_vector, example$$
+# $index example, hessian_vector$$
+#
+# $code
+# $verbatim%example/hessian_vector.py%0%# BEGIN CODE%# END CODE%1%$$
+# $$
+# $end
+# BEGIN CODE
+from pycppad import *
+# Example using a_float -----------------------------------------------------
+def pycppad_test_hessian_vector():
+  delta = 10. * numpy.finfo(float).eps
+  x     = numpy.array( [ 0., 0. ] )
+  a_x   = independent(x)
+  a_y   = numpy.array( [ 
+    a_x[0] * exp(a_x[1]) , 
+    a_x[0] * sin(a_x[1]) ,
+    a_x[0] * cos(a_x[1]) 
+  ] )
+  f   = adfun(a_x, a_y)
+  x   = numpy.array( [ 2., 3. ] )
+  w   = numpy.array( [ 0., 1., 0. ] ) # Hessian of x0 * sin(x1)
+  H   = f.hessian(x, w)
+  # one vector
+  v   = numpy.array( [ 1., 2. ] )
+  h   = f.hessian_vector(x, w, v)
+  assert h.shape == (2,)
+  check = numpy.dot(H, v)
+  for j in range(2) :
+    assert abs( h[j] - check[j] ) < delta
+  # a block of vectors
+  V   = numpy.array( [ [ 1., 0., 3. ] , [ 0., 1., 4. ] ] )
+  h   = f.hessian_vector(x, w, V)
+  assert h.shape == (2, 3)
+  check = numpy.dot(H, V)
+  for j in range(2) :
+    for k in range(3) :
+      assert abs( h[j,k] - check[j,k] ) < delta
+# Example using a2float -----------------------------------------------------
+def pycppad_test_hessian_vector_a2():
+  delta = 10. * numpy.finfo(float).eps
+  a_x   = ad( numpy.array( [ 0., 0. ] ) )
+  a2x   = independent(a_x)
+  a2y   = numpy.array( [ a2x[0] * sin(a2x[1]) ] )
+  a_f   = adfun(a2x, a2y)
+  x     = numpy.array( [ 2., 3. ] )
+  a_x   = ad(x)
+  a_w   = ad( numpy.array( [ 1. ] ) )
+  a_v   = ad( numpy.array( [ 1., 0. ] ) )
+  a_h   = a_f.hessian_vector(a_x, a_w, a_v)
+  assert abs( a_h[0] - 0.        ) < delta
+  assert abs( a_h[1] - cos(x[1]) ) < delta
+# END CODE
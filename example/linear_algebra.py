@@ -0,0 +1,55 @@
+# $begin linear_algebra.py$$ $newlinech #$$
+# $spell
+#	matmul
+#	lu
+#	cholesky
+# $$
+#
+# $section Dense Linear Algebra: Example and Test$$
+#
+# $index matmul, example$$
+# $index lu_solve, example$$
+# $index cholesky_solve, example$$
+#
+# $code
+# $verbatim%example/linear_algebra.py%0%# BEGIN CODE%# END CODE%1%$$
+# $$
+# $end
+# BEGIN CODE
+from pycppad import *
+def pycppad_test_linear_algebra() :
+  # the matrix a = [ [ x0 , 1 ] , [ 1 , x1 ] ]
+  x   = numpy.array( [ 2. , 3. ] )
+  a_x = independent(x)
+  a_a = numpy.array( [ [ a_x[0] , 1. ] , [ 1. , a_x[1] ] ] )
+  b   = numpy.array( [ 1. , 2. ] )
+  a_c = matmul(a_a, b)                  # a * b
+  a_y = lu_solve(a_a, b)                # a^{-1} * b
+  a_z = cholesky_solve(a_a, b)          # a^{-1} * b (a is positive definite)
+  f   = adfun(a_x, numpy.concatenate( [ a_c, a_y, a_z ] ) )
+  # each call is one operation
+  assert f.stats()['recorded_op']['atomic'] == 3
+  #
+  # check the values
+  def g(x) :
+    a   = numpy.array( [ [ x[0] , 1. ] , [ 1. , x[1] ] ] )
+    y   = numpy.linalg.solve(a, b)
+    return numpy.concatenate( [ numpy.dot(a, b), y, y ] )
+  v   = f.forward(0, x)
+  assert numpy.all( abs( v - g(x) ) < 1e-10 )
+  #
+  # check the derivative using central differences
+  J   = f.jacobian(x)
+  h   = 1e-6
+  for j in range(2) :
+    e    = numpy.zeros(2)
+    e[j] = h
+    dg   = ( g(x + e) - g(x - e) ) / (2. * h)
+    assert numpy.all( abs( J[:, j] - dg ) < 1e-6 )
+  #
+  # second derivatives use the same operations
+  w   = numpy.array( [ 0., 0., 1., 0., 0., 0. ] )
+  H   = f.hessian(x, w)
+  assert H.shape == (2, 2)
+  assert abs( H[0, 1] - H[1, 0] ) < 1e-10
+# END CODE
@@ -0,0 +1,72 @@
+# $begin linear_operator.py$$ $newlinech #$$
+# $spell
+#	Jacobian
+#	matvec
+#	rmatvec
+# $$
+#
+# $section Jacobian Linear Operator: Example and Test$$
+#
+# $index linear_operator, example$$
+# $index example, linear_operator$$
+#
+# $code
+# $verbatim%example/linear_operator.py%0%# BEGIN CODE%# END CODE%1%$$
+# $$
+# $end
+# BEGIN CODE
+from pycppad import *
+# Example using a_float -----------------------------------------------------
+def pycppad_test_linear_operator():
+  delta = 10. * numpy.finfo(float).eps
+  x     = numpy.array( [ 0., 0. ] )
+  a_x   = independent(x)
+  a_y   = numpy.array( [ 
+    a_x[0] * exp(a_x[1]) , 
+    a_x[0] * sin(a_x[1]) ,
+    a_x[0] * cos(a_x[1]) 
+  ] )
+  f   = adfun(a_x, a_y)
+  x   = numpy.array( [ 2., 3. ] )
+  J   = f.jacobian(x)
+  A   = f.linear_operator(x)
+  assert A.shape == (3, 2)
+  # Jacobian times a vector
+  v   = numpy.array( [ 1., 2. ] )
+  jv  = A.matvec(v)
+  check = numpy.dot(J, v)
+  for i in range(3) :
+    assert abs( jv[i] - check[i] ) < delta
+  # changing the zero order Taylor coefficients of f does not affect A
+  f.forward(0, numpy.array( [ 5., 6. ] ) )
+  # vector times the Jacobian
+  u   = numpy.array( [ 1., 2., 3. ] )
+  uj  = A.rmatvec(u)
+  check = numpy.dot(u, J)
+  for j in range(2) :
+    assert abs( uj[j] - check[j] ) < delta
+  # block versions
+  V   = numpy.array( [ [ 1., 0., 3. ] , [ 0., 1., 4. ] ] )
+  JV  = A.matmat(V)
+  assert JV.shape == (3, 3)
+  check = numpy.dot(J, V)
+  for i in range(3) :
+    for k in range(3) :
+      assert abs( JV[i,k] - check[i,k] ) < delta
+  U   = numpy.array( [ [ 1., 0. ] , [ 0., 1. ] , [ 2., 3. ] ] )
+  UJ  = A.rmatmat(U)
+  assert UJ.shape == (2, 2)
+  check = numpy.dot(J.T, U)
+  for j in range(2) :
+    for k in range(2) :
+      assert abs( UJ[j,k] - check[j,k] ) < delta
+  # optimize frees the Taylor coefficients of f, so the next product
+  # detects that A is stale and recomputes them at x
+  id_before = f.taylor_id_()
+  f.optimize()
+  assert f.taylor_id_() != id_before
+  jv    = A.matvec(v)
+  check = numpy.dot(J, v)
+  for i in range(3) :
+    assert abs( jv[i] - check[i] ) < delta
+# END CODE
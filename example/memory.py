@@ -0,0 +1,54 @@
+# $begin memory.py$$ $newlinech #$$
+# $spell
+# $$
+#
+# $section Memory Accounting: Example and Test$$
+#
+# $index memory, example$$
+# $index example, memory$$
+#
+# $code
+# $verbatim%example/memory.py%0%# BEGIN CODE%# END CODE%1%$$
+# $$
+# $end
+# BEGIN CODE
+from pycppad import *
+def pycppad_test_memory():
+  n   = 50
+  x   = numpy.ones(n)
+  a_x = independent(x)
+  a_s = 0.
+  for j in range(n) :
+    a_s = a_s + a_x[j] * a_x[j]
+  a_y = numpy.array( [ a_s ] )
+  f   = adfun(a_x, a_y)
+  #
+  # memory used by f
+  f.forward(0, x)
+  d   = f.memory()
+  assert d['op_seq_bytes'] > 0
+  assert d['bytes'] == d['op_seq_bytes'] + d['taylor_bytes']
+  # higher order Taylor coefficients increase the memory used by f
+  before = d['taylor_bytes']
+  f.forward(1, x)
+  f.forward(2, 0. * x)
+  d   = f.memory()
+  assert d['taylor_bytes'] == 3 * before
+  assert d['peak_bytes'] >= d['bytes']
+  #
+  # memory used by all the threads
+  reset_peak_memory()
+  d   = memory()
+  assert d['peak_inuse'] >= d['inuse']
+  assert len( d['thread'] ) >= 1
+  assert d['thread'][0]['inuse'] <= d['inuse']
+  #
+  # hold freed memory for reuse and then release it
+  hold_memory(True)
+  del f
+  assert memory()['available'] > 0
+  released = release_memory()
+  assert released > 0
+  assert memory()['available'] == 0
+  hold_memory(False)
+# END CODE
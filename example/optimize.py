@@ -1,5 +1,7 @@
 # $begin optimize.py$$ $newlinech #$$
 # $spell
+#	a2float
+#	adfun
 # $$
 #
 # $section Optimize Function Object: Example and Test$$
@@ -41,4 +43,26 @@ def pycppad_test_optimize():
   assert sum_after  == float(n_sum)
   # expect sec_before to be less than 2 times sec_after
   assert( sec_after * 1.5 <= sec_before )
+# Example using a2float -----------------------------------------------------
+def pycppad_test_optimize_a2():
+  # optimize when the function object is created
+  n_sum  = 100
+  x      = ad( numpy.array( [ 0. ] ) )
+  a2x    = independent(x)
+  a2sum  = 0.
+  for i in range(n_sum) :
+    a2sum = a2sum + a2x[0];
+  a2y    = numpy.array( [ a2sum ] )
+  f      = adfun(a2x, a2y, optimize = True)
+  assert f.forward(0, ad( numpy.array( [ 1. ] ) ) )[0] == float(n_sum)
+  # the return value reports the sizes before and after optimize
+  r      = f.optimize()
+  before = r['before']
+  after  = r['after']
+  assert after['size_var'] <= before['size_var']
+  # the sizes before the first optimize are reported by stats
+  s      = f.stats()
+  assert s['before_optimize']['size_var'] > n_sum
+  assert s['size_var'] == after['size_var']
+  assert after['size_var'] < n_sum
 # END CODE
@@ -0,0 +1,63 @@
+# $begin profile.py$$ $newlinech #$$
+# $spell
+# $$
+#
+# $section Operation Profiler: Example and Test$$
+#
+# $index profile, example$$
+# $index example, profile$$
+#
+# $code
+# $verbatim%example/profile.py%0%# BEGIN CODE%# END CODE%1%$$
+# $$
+# $end
+# BEGIN CODE
+from pycppad import *
+import os
+import tempfile
+def pycppad_test_profile():
+  n   = 10
+  x   = numpy.array( n * [ 0.5 ] )
+  a_x = independent(x)
+  record_label('sum')
+  a_s = 0.
+  for j in range(n) :
+    a_s = a_s + a_x[j]
+  record_label('exp')
+  a_e = 0.
+  for j in range(n) :
+    a_e = a_e + exp( a_x[j] )
+  a_y = numpy.array( [ a_s * a_e ] )
+  f   = adfun(a_x, a_y)
+  #
+  f.profile(True)
+  for k in range(10) :
+    f.forward(0, x)
+    f.reverse(1, numpy.array( [ 1. ] ) )
+  f.profile(False)
+  #
+  report = f.profile_report()
+  # the exp function is the most expensive operation
+  assert report[0]['label'] == 'exp'
+  assert report[0]['op']    == 'exp'
+  assert report[0]['count'] == n
+  # the final multiply is also in the 'exp' label
+  counts = dict()
+  for row in report :
+    counts[ (row['label'], row['op']) ] = row['count']
+  assert counts == { ('sum','add') : n, ('exp','exp') : n, ('exp','add') : n,
+    ('exp','mul') : 1 }
+  total = 0.
+  for row in report :
+    total += row['estimated_fraction']
+    assert row['measured_seconds'] == report[0]['measured_seconds']
+  assert abs( total - 1. ) < 1e-10
+  #
+  (fd, file_name) = tempfile.mkstemp()
+  os.close(fd)
+  f.profile_flamegraph(file_name)
+  lines = open(file_name, 'r').readlines()
+  os.remove(file_name)
+  assert len(lines) == len(report)
+  assert lines[0].startswith('adfun_estimated;exp;exp ')
+# END CODE
@@ -0,0 +1,46 @@
+# $begin recording_threads.py$$ $newlinech #$$
+# $spell
+# $$
+#
+# $section Record in More Than One Thread: Example and Test$$
+#
+# $index recording_threads, example$$
+# $index example, recording_threads$$
+#
+# $code
+# $verbatim%example/recording_threads.py%0%# BEGIN CODE%# END CODE%1%$$
+# $$
+# $end
+# BEGIN CODE
+from pycppad import *
+import threading
+def pycppad_test_recording_threads():
+  recording_threads(2)
+  started = threading.Event()
+  resume  = threading.Event()
+  result  = dict()
+  def record_cube() :
+    x   = numpy.array( [ 2. ] )
+    a_x = independent(x)
+    a_y = numpy.array( [ a_x[0] * a_x[0] ] )
+    # let the main thread record while this recording is in progress
+    started.set()
+    resume.wait()
+    a_y = a_y * a_x[0]
+    f   = adfun(a_x, a_y)
+    result['cube'] = f.jacobian( numpy.array( [ 3. ] ) )[0, 0]
+  thread = threading.Thread(target = record_cube)
+  thread.start()
+  started.wait()
+  # abort_recording only aborts recordings started by this thread
+  a_x = independent( numpy.array( [ 5. ] ) )
+  abort_recording()
+  a_x = independent( numpy.array( [ 1. ] ) )
+  a_y = numpy.array( [ sin( a_x[0] ) ] )
+  f   = adfun(a_x, a_y)
+  resume.set()
+  thread.join()
+  assert abs( f.jacobian( numpy.array( [ 0. ] ) )[0, 0] - 1. ) < 1e-10
+  assert abs( result['cube'] - 27. ) < 1e-10
+  recording_threads(1)
+# END CODE
@@ -0,0 +1,43 @@
+# $begin reduce.py$$ $newlinech #$$
+# $spell
+#	sumsq
+# $$
+#
+# $section Reductions: Example and Test$$
+#
+# $index reduce, example$$
+# $index example, reduce$$
+#
+# $code
+# $verbatim%example/reduce.py%0%# BEGIN CODE%# END CODE%1%$$
+# $$
+# $end
+# BEGIN CODE
+from pycppad import *
+def pycppad_test_reduce() :
+  n   = 100
+  x   = numpy.array( [ 0.01 * j for j in range(n) ] )
+  w   = numpy.array( [ j + 1. for j in range(n) ] )
+  a_x = independent(x)
+  a_r = a_x - 0.5                       # residuals
+  a_y = numpy.array( [
+    reduce_sum(a_x)     ,               # sum of x
+    reduce_sumsq(a_r)   ,               # least squares objective
+    reduce_dot(w, a_x)                  # weighted sum of x
+  ] )
+  f   = adfun(a_x, a_y)
+  # each reduction is one operation and one variable
+  s   = f.stats()
+  assert s['recorded_op']['atomic'] == 3
+  assert not 'add' in s['recorded_op']
+  y   = f.forward(0, x)
+  assert abs( y[0] - numpy.sum(x) ) < 1e-10
+  assert abs( y[1] - numpy.sum( (x - 0.5) ** 2 ) ) < 1e-10
+  assert abs( y[2] - numpy.dot(w, x) ) < 1e-10
+  J   = f.jacobian(x)
+  assert numpy.all( J[0, :] == 1. )
+  assert numpy.all( abs( J[1, :] - 2. * (x - 0.5) ) < 1e-10 )
+  assert numpy.all( J[2, :] == w )
+  H   = f.hessian(x, numpy.array( [ 0., 1., 0. ] ) )
+  assert numpy.all( H == 2. * numpy.eye(n) )
+# END CODE
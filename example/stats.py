@@ -0,0 +1,51 @@
+# $begin stats.py$$ $newlinech #$$
+# $spell
+# $$
+#
+# $section Operation Sequence Statistics: Example and Test$$
+#
+# $index stats, example$$
+# $index example, stats$$
+#
+# $code
+# $verbatim%example/stats.py%0%# BEGIN CODE%# END CODE%1%$$
+# $$
+# $end
+# BEGIN CODE
+from pycppad import *
+# Example using a_float -----------------------------------------------------
+def pycppad_test_stats():
+  n_sum = 100
+  x     = numpy.array( [ 0., 0. ] )
+  a_x   = independent(x)
+  a_sum = 0.
+  for i in range(n_sum) :
+    a_sum = a_sum + a_x[0]
+  # a_sum does not affect the dependent variables
+  a_y   = numpy.array( [ a_x[0] , sin( a_x[1] ) * a_x[0] ] )
+  f     = adfun(a_x, a_y)
+  s     = f.stats()
+  assert s['n'] == 2
+  assert s['m'] == 2
+  assert s['size_var'] > n_sum
+  assert s['recorded_op']['add'] == n_sum
+  assert s['recorded_op']['sin'] == 1
+  assert s['recorded_op']['mul'] == 1
+  assert not 'div' in s['recorded_op']
+  assert not 'before_optimize' in s
+  # Taylor coefficient memory grows with the order of forward sweeps
+  f.forward(0, x)
+  f.forward(1, numpy.array( [ 1., 0. ] ) )
+  s     = f.stats()
+  assert s['size_order'] == 2
+  assert s['taylor_bytes'] >= 2 * s['size_var'] * 8
+  assert s['bytes'] == s['op_seq_bytes'] + s['taylor_bytes']
+  # optimize removes the variables used to compute a_sum
+  f.optimize()
+  s     = f.stats()
+  assert s['before_optimize']['size_var'] > n_sum
+  assert s['size_var'] < s['before_optimize']['size_var']
+  # the histogram describes the recording before optimization
+  assert not 'recorded_op' in s
+  assert s['before_optimize']['recorded_op']['add'] == n_sum
+# END CODE
@@ -0,0 +1,67 @@
+# $begin value_and_grad.py$$ $newlinech #$$
+# $spell
+#	jac
+#	hess
+# $$
+#
+# $section Fused Value and Derivative Drivers: Example and Test$$
+#
+# $index value_and_grad, example$$
+# $index value_jac_hess, example$$
+# $index example, value_and_grad$$
+# $index example, value_jac_hess$$
+#
+# $code
+# $verbatim%example/value_and_grad.py%0%# BEGIN CODE%# END CODE%1%$$
+# $$
+# $end
+# BEGIN CODE
+from pycppad import *
+# Example using a_float -----------------------------------------------------
+def pycppad_test_value_and_grad():
+  delta = 10. * numpy.finfo(float).eps
+  x     = numpy.array( [ 0., 0. ] )
+  a_x   = independent(x)
+  a_y   = numpy.array( [ a_x[0] * sin(a_x[1]) ] )
+  f     = adfun(a_x, a_y)
+  x     = numpy.array( [ 2., 3. ] )
+  (v, g) = f.value_and_grad(x)
+  assert abs( v    - x[0] * sin(x[1]) ) < delta
+  assert abs( g[0] -        sin(x[1]) ) < delta
+  assert abs( g[1] - x[0] * cos(x[1]) ) < delta
+
+def pycppad_test_value_jac_hess():
+  delta = 10. * numpy.finfo(float).eps
+  x     = numpy.array( [ 0., 0. ] )
+  a_x   = independent(x)
+  a_y   = numpy.array( [ 
+    a_x[0] * exp(a_x[1]) , 
+    a_x[0] * sin(a_x[1]) ,
+    a_x[0] * cos(a_x[1]) 
+  ] )
+  f   = adfun(a_x, a_y)
+  x   = numpy.array( [ 2., 3. ] )
+  w   = numpy.array( [ 0., 1., 0. ] ) # compute Hessian of x0 * sin(x1)
+  (y, J, H) = f.value_jac_hess(x, w)
+  assert abs( y[1]   - x[0] * sin(x[1]) ) < delta
+  assert abs( J[0,0] -        exp(x[1]) ) < delta
+  assert abs( J[0,1] - x[0] * exp(x[1]) ) < delta
+  assert abs( J[2,1] + x[0] * sin(x[1]) ) < delta
+  assert abs( H[0,0] - 0.               ) < delta
+  assert abs( H[0,1] - cos(x[1])        ) < delta
+  assert abs( H[1,0] - cos(x[1])        ) < delta
+  assert abs( H[1,1] + x[0] * sin(x[1]) ) < delta
+# Example using a2float -----------------------------------------------------
+def pycppad_test_value_and_grad_a2():
+  delta = 10. * numpy.finfo(float).eps
+  a_x   = ad( numpy.array( [ 0., 0. ] ) )
+  a2x   = independent(a_x)
+  a2y   = numpy.array( [ a2x[0] * sin(a2x[1]) ] )
+  a_f   = adfun(a2x, a2y)
+  x     = numpy.array( [ 2., 3. ] )
+  a_x   = ad(x)
+  (a_v, a_g) = a_f.value_and_grad(a_x)
+  assert abs( a_v    - x[0] * sin(x[1]) ) < delta
+  assert abs( a_g[0] -        sin(x[1]) ) < delta
+  assert abs( a_g[1] - x[0] * cos(x[1]) ) < delta
+# END CODE
@@ -0,0 +1,51 @@
+# $begin vector_op.py$$ $newlinech #$$
+# $spell
+#	vsin
+#	vadd
+#	vdot
+#	vsum
+#	op
+# $$
+#
+# $section Array Operations: Example and Test$$
+#
+# $index vector_op, example$$
+# $index example, vector_op$$
+# $index vsum, example$$
+# $index vdot, example$$
+#
+# $code
+# $verbatim%example/vector_op.py%0%# BEGIN CODE%# END CODE%1%$$
+# $$
+# $end
+# BEGIN CODE
+from pycppad import *
+def pycppad_test_vector_op() :
+  x   = numpy.array( [ 1. , 2. , 3. ] )
+  A   = numpy.array( [ [ 1. , 0. , 2. ] , [ 0. , 3. , 0. ] ] )
+  a_x = independent(x)
+  # element by element operations
+  a_s = vsin(a_x)
+  a_t = vadd(a_s, 2. * a_x)
+  a_u = vmul(a_x, 3.)
+  # sum and matrix vector product
+  a_v = vsum(a_t)
+  a_w = vdot(A, a_x)
+  a_y = numpy.concatenate( [ a_u , [ a_v ] , a_w ] )
+  f   = adfun(a_x, a_y)
+  # the operations recorded are the same as for the python expressions
+  y   = f.forward(0, x)
+  assert numpy.all( y[0:3] == 3. * x )
+  assert abs( y[3] - numpy.sum( numpy.sin(x) + 2. * x ) ) < 1e-10
+  assert numpy.all( y[4:6] == numpy.dot(A, x) )
+  J   = f.jacobian(x)
+  assert abs( J[3, 1] - ( numpy.cos(2.) + 2. ) ) < 1e-10
+  assert numpy.all( J[4:6, :] == A )
+  # 2. * a_x, vmul and the three non-zero elements of A
+  assert f.stats()['recorded_op']['mul'] == 9
+  # a2float elements give a2float results
+  a2x = independent( ad(x) )
+  a2y = vexp(a2x)
+  assert isinstance(a2y[0], a2float)
+  a_f = adfun(a2x, a2y)
+# END CODE
@@ -39,6 +39,8 @@
 # If $icode x$$ is an $code numpy.array$$,
 # $icode a_x$$ is also an $code numpy.array$$ with the 
 # same shape as $icode x$$.
+# The elements of an array are converted in one C++ loop
+# (not one python call per element).
 # 
 # $children%
 #	example/ad.py
@@ -79,6 +81,9 @@
 # If $icode a_x$$ is an $code numpy.array$$,
 # $icode x$$ is also an $code numpy.array$$ with the 
 # same shape as $icode a_x$$.
+# If all the elements of $icode a_x$$ are $code a_float$$,
+# the elements of $icode x$$ have type $code float$$
+# and are stored as a contiguous array of doubles.
 # 
 # $children%
 #	example/value.py
@@ -98,6 +103,40 @@ import pycppad.cppad_
 from cppad_ import a_float
 from cppad_ import a2float
 from cppad_ import abort_recording
+from cppad_ import recording_threads
+from cppad_ import counters
+from cppad_ import reset_counters
+from cppad_ import record_label
+from cppad_ import memory
+from cppad_ import release_memory
+from cppad_ import reset_peak_memory
+from cppad_ import hold_memory
+from cppad_ import vabs
+from cppad_ import varccos
+from cppad_ import varcsin
+from cppad_ import varctan
+from cppad_ import vcos
+from cppad_ import vcosh
+from cppad_ import vexp
+from cppad_ import vlog
+from cppad_ import vlog10
+from cppad_ import vsin
+from cppad_ import vsinh
+from cppad_ import vsqrt
+from cppad_ import vtan
+from cppad_ import vtanh
+from cppad_ import vadd
+from cppad_ import vsub
+from cppad_ import vmul
+from cppad_ import vdiv
+from cppad_ import vsum
+from cppad_ import vdot
+from cppad_ import matmul
+from cppad_ import lu_solve
+from cppad_ import cholesky_solve
+from cppad_ import reduce_sum
+from cppad_ import reduce_sumsq
+from cppad_ import reduce_dot
 from cppad_ import condexp_lt
 from cppad_ import condexp_le
 from cppad_ import condexp_eq
@@ -118,10 +157,7 @@ def ad(x) :
   elif isinstance(x, a_float) :
     return a2float(x)
   elif isinstance(x, numpy.ndarray) :
-    s      = x.shape
-    length = numpy.prod(s)
-    a_x    = numpy.array( list(ad(xi) for xi in x.flat) )
-    return a_x.reshape(s)
+    return cppad_.ad_(x)
   else :
     raise NotImplementedError(
       'ad(x): only implemented where x an int, float, a_float or '
@@ -139,10 +175,7 @@ def value(a_x) :
   elif isinstance(a_x, a2float) :
     return cppad_.a_float_(a_x);
   elif isinstance(a_x, numpy.ndarray) :
-    s      = a_x.shape
-    length = numpy.prod(s)
-    x      = numpy.array( list(value(a_xi) for a_xi in a_x.flat) )
-    return x.reshape(s)
+    return cppad_.value_(a_x)
   else :
     msg = 'type(a_x) = ' + str( type(a_x) ) + '\n'
     msg += 'value(a_x): only implemented where a_x is an a_float, a2float,\n'
@@ -397,6 +397,15 @@ $begin optimize$$
 $spell
 	Taylor
 	var
+	dict
+	op
+	seq
+	arg
+	par
+	cppad
+	adfun
+	bool
+	str
 $$
 
 $section Optimize an AD Function Object Tape$$
@@ -409,7 +418,9 @@ $index speed, optimize$$
 $index memory, optimize$$
 
 $head Syntax$$
-$icode%f%.optimize()%$$
+$icode%r% = %f%.optimize()
+%$$
+$icode%r% = %f%.optimize(%options%)%$$
 
 
 $head Purpose$$
@@ -420,7 +431,42 @@ and thereby the time and memory, required to
 compute function and derivative values. 
 
 $head f$$
-The object $icode f$$ is an $cref adfun$$ object.
+The object $icode f$$ is an $cref adfun$$ object
+with level zero or level one (see $cref/level/adfun/f/level/$$);
+e.g., the level one functions used to record second derivatives
+can be optimized before they are used.
+
+$head options$$
+The argument $icode options$$ is a $code str$$ that is passed to the
+CppAD $code optimize$$ routine; for example,
+$code no_conditional_skip$$ or $code no_compare_op$$ 
+(see the CppAD documentation for the options that it supports).
+The empty string, which is the default, uses the CppAD default options.
+CppAD versions before 2015 do not support options.
+If the setting $code optimize_options$$ in $code setup.py$$ is not 
+$code True$$, a non-empty $icode options$$ raises
+$code NotImplementedError$$.
+
+$head r$$
+The return value $icode r$$ is a $code dict$$ with the keys
+$code before$$ and $code after$$.
+Each value is a $code dict$$ with the keys
+$code size_var$$ (number of variables),
+$code size_op$$ (number of operations),
+$code size_op_arg$$, $code size_par$$ and $code op_seq_bytes$$,
+and their values before and after this optimization; 
+see $cref stats$$.
+
+$head Taylor Coefficients$$
+The Taylor coefficients stored in $icode f$$ are freed by
+$code optimize$$, so a zero order $cref forward$$ must be done before
+higher order forward or reverse calls.
+A $cref linear_operator$$ created before the optimization 
+recomputes the zero order coefficients at its point.
+
+$head Construction$$
+The function $icode f$$ can also be optimized when it is created by
+$codei%adfun(%a_x%, %a_y%, %optimize%)%$$; see $cref adfun$$.
 
 $head Efficiency$$
 The $code optimize$$ member function
@@ -433,15 +479,846 @@ $children%
 $head Example$$ 
 The file $cref optimize.py$$ contains an example and test of this operation.
 
+$end
+---------------------------------------------------------------------------
+$begin value_and_grad$$
+$spell
+	numpy
+	adfun
+	jac
+	hess
+$$
+
+$section Fused Function Value and Derivative Drivers$$
+
+$index value_and_grad$$
+$index value_jac_hess$$
+$index fused, value and derivative$$
+$index gradient, with value$$
+$index value, with derivative$$
+
+$head Syntax$$
+$codei%(%v%, %g%) = %f%.value_and_grad(%x%)
+%$$
+$codei%(%y%, %J%, %H%) = %f%.value_jac_hess(%x%, %w%)%$$
+
+$head Purpose$$
+These routines compute a function value together with its derivatives
+using one call, one conversion of the arguments,
+and the minimal number of sweeps through the operation sequence;
+i.e., the zero order forward sweep is done once and shared by the
+derivative calculations.
+We use $latex F : \B{R}^n \rightarrow \B{R}^m$$ to denote the 
+function corresponding to the $code adfun$$ object $cref/f/adfun/f/$$.
+
+$head f$$
+The object $icode f$$ must be an $cref adfun$$ object.
+We use $cref/level/adfun/f/level/$$ for the AD $cref ad$$ level of 
+this object.
+For $code value_and_grad$$, the range size $cref/m/adfun/f/m/$$
+must be one.
+
+$head x$$
+The argument $icode x$$ is a $code numpy.array$$ with one dimension
+(i.e., a vector) with length equal to the domain size $cref/n/adfun/f/n/$$
+for the function $icode f$$.
+It specifies the argument value at which the function and derivatives
+are computed.
+If the AD $cref/level/adfun/f/level/$$ for $icode f$$ is zero,
+all the elements of $icode x$$ must be either $code int$$ or instances
+of $code float$$.
+If the AD $cref/level/adfun/f/level/$$ for $icode f$$ is one,
+all the elements of $icode x$$ must be $code a_float$$ objects.
+
+$head w$$
+The argument $icode w$$ is a $code numpy.array$$ with one dimension
+with length equal to the range size $cref/m/adfun/f/m/$$
+and the same element type as $icode x$$.
+It specifies the weighting vector for the Hessian $icode H$$.
+
+$head v$$
+The return value $icode v$$ is the function value $latex F_0 (x)$$.
+It is a $code float$$ ($code a_float$$) if the AD level for $icode f$$
+is zero (one).
+
+$head g$$
+The return value $icode g$$ is a $code numpy.array$$ with one dimension
+and length $icode n$$ equal to the gradient $latex F_0^{(1)} (x)$$.
+
+$head y$$
+The return value $icode y$$ is a $code numpy.array$$ with one dimension
+and length $icode m$$ equal to $latex F(x)$$.
+
+$head J$$
+The return value $icode J$$ is a $code numpy.array$$ with
+$icode m$$ rows and $icode n$$ columns equal to $latex F^{(1)} (x)$$;
+see $cref jacobian$$.
+
+$head H$$
+The return value $icode H$$ is a $code numpy.array$$ with
+$icode n$$ rows and $icode n$$ columns equal to
+$latex \[
+	H = w_0 * F_0^{(2)} (x) + \cdots + w_{m-1} * F_{m-1}^{(2)} (x)
+\] $$
+see $cref hessian$$.
+
+$head Efficiency$$
+The call $icode%f%.value_and_grad(%x%)%$$
+does one zero order forward sweep and one first order reverse sweep.
+The call $icode%f%.value_jac_hess(%x%, %w%)%$$
+does one zero order forward sweep and, for each of the $icode n$$ domain
+directions, one first order forward sweep (used for both $icode J$$ and
+$icode H$$) and one second order reverse sweep.
+
+$children%
+	example/value_and_grad.py
+%$$
+$head Example$$ 
+The file $cref value_and_grad.py$$ contains an example and test of
+these operations.
+
+$end
+---------------------------------------------------------------------------
+$begin hessian_vector$$
+$spell
+	numpy
+	adfun
+$$
+
+$section Hessian Times a Vector or Matrix$$
+
+$index hessian_vector$$
+$index hessian, times vector$$
+$index vector, hessian times$$
+$index forward over reverse$$
+
+$head Syntax$$
+$icode%h% = %f%.hessian_vector(%x%, %w%, %v%)%$$
+
+$head Purpose$$
+This routine computes the product of the Hessian of the weighted sum
+$latex \[
+	w_0 * F_0 (x) + \cdots + w_{m-1} * F_{m-1} (x)
+\] $$
+times a vector, or times each column of a matrix,
+without forming the Hessian.
+Here $latex F : \B{R}^n \rightarrow \B{R}^m$$ is the 
+function corresponding to the $code adfun$$ object $cref/f/adfun/f/$$.
+
+$head f$$
+The object $icode f$$ must be an $cref adfun$$ object.
+We use $cref/level/adfun/f/level/$$ for the AD $cref ad$$ level of 
+this object.
+
+$head x$$
+The argument $icode x$$ is a $code numpy.array$$ with one dimension
+(i.e., a vector) with length equal to the domain size $cref/n/adfun/f/n/$$
+for the function $icode f$$.
+It specifies the argument value at which the derivative is computed.
+If the AD $cref/level/adfun/f/level/$$ for $icode f$$ is zero,
+all the elements of $icode x$$ must be either $code int$$ or instances
+of $code float$$.
+If the AD $cref/level/adfun/f/level/$$ for $icode f$$ is one,
+all the elements of $icode x$$ must be $code a_float$$ objects.
+
+$head w$$
+The argument $icode w$$ is a $code numpy.array$$ with one dimension
+with length equal to the range size $cref/m/adfun/f/m/$$
+and the same element type as $icode x$$.
+It specifies the weighting vector for the Hessian.
+
+$head v$$
+The argument $icode v$$ is a $code numpy.array$$ with the same element
+type as $icode x$$.
+It is either a vector with length $icode n$$,
+or a matrix with $icode n$$ rows and $icode k$$ columns.
+
+$head h$$
+The return value $icode h$$ is a $code numpy.array$$ with the same shape 
+as $icode v$$.
+It is set to 
+$latex \[
+	h = [ w_0 * F_0^{(2)} (x) + \cdots + w_{m-1} * F_{m-1}^{(2)} (x) ] * v
+\] $$
+If the AD $cref/level/adfun/f/level/$$ for $icode f$$ is zero,
+all the elements of $icode h$$ will be instances of $code float$$.
+If the AD $cref/level/adfun/f/level/$$ for $icode f$$ is one,
+all the elements of $icode h$$ will be $code a_float$$ objects.
+
+$head Efficiency$$
+One zero order forward sweep is done at $icode x$$ and its Taylor
+coefficients are used for all the columns of $icode v$$.
+Each column then requires one first order forward sweep
+and one second order reverse sweep (forward over reverse).
+The memory used does not depend on $latex n^2$$.
+
+$children%
+	example/hessian_vector.py
+%$$
+$head Example$$ 
+The file $cref hessian_vector.py$$ contains an example and test of
+this operation.
+
+$end
+---------------------------------------------------------------------------
+$begin derivative_adfun$$
+$spell
+	adfun
+	jacobian
+	hessian
+	str
+	numpy
+$$
+
+$section Record a Derivative as a Function Object$$
+
+$index derivative_adfun$$
+$index derivative, function object$$
+$index gradient, function object$$
+$index jacobian, function object$$
+$index hessian, vector function object$$
+
+$head Syntax$$
+$icode%g% = %f%.derivative_adfun(%kind%)%$$
+
+$head Purpose$$
+We use $latex F : \B{R}^n \rightarrow \B{R}^m$$ to denote the 
+function corresponding to the $code adfun$$ object $cref/f/adfun/f/$$.
+This creates a new $cref adfun$$ object $icode g$$ 
+that evaluates a derivative of $latex F$$.
+The operation sequence in $icode g$$ is one atomic operation
+that replays a private copy of $icode f$$ 
+(at the same level as $icode f$$) each time it is evaluated;
+it is not a recording of the operations that compute the derivative
+and it is not optimized for the derivative.
+Thus $icode%g%.forward(0, %x%)%$$ does the same sweeps through 
+the copy of $icode f$$ as the corresponding $icode f$$ calls would,
+but without converting between numpy arrays and $code a_float$$ objects.
+
+$head kind$$
+The argument $icode kind$$ is a $code str$$ with one of the following
+values:
+$table
+$icode kind$$ $cnext $icode g$$ argument $cnext $icode g$$ value
+$rnext
+$code 'gradient'$$ $cnext $latex x \in \B{R}^n$$ $cnext
+	$latex F^{(1)} (x)^\R{T} \in \B{R}^n$$
+$rnext
+$code 'jacobian'$$ $cnext $latex x \in \B{R}^n$$ $cnext
+	$latex F^{(1)} (x) \in \B{R}^{m \times n}$$ in row major order
+$rnext
+$code 'hessian_vector'$$ $cnext $latex (x, v) \in \B{R}^{2 n}$$ $cnext
+	$latex F^{(2)} (x) v \in \B{R}^n$$
+$tend
+The range dimension $latex m$$ must be one for the 
+$code 'gradient'$$ and $code 'hessian_vector'$$ kinds.
+
+$head g$$
+Only zero order $cref forward$$ mode is supported for
+the $code 'jacobian'$$ and $code 'hessian_vector'$$ kinds.
+For the $code 'gradient'$$ kind, first order $cref forward$$ 
+and $cref reverse$$ (and hence $cref jacobian$$) are also supported;
+i.e., the Hessian of $latex F$$ is the $cref jacobian$$ of $icode g$$.
+Any other order (e.g., $icode%g%.hessian%$$ or 
+$icode%g%.jacobian%$$ for the $code 'jacobian'$$ kind) raises
+$code NotImplementedError$$.
+The object $icode g$$ holds a reference to $icode f$$ and
+later calls using $icode f$$ do not change the values computed by 
+$icode g$$.
+
+$children%
+	example/derivative_adfun.py
+%$$
+$head Example$$ 
+The file $cref derivative_adfun.py$$ contains an example and test of
+this operation.
+
+$end
+---------------------------------------------------------------------------
+$begin hessian_diagonal$$
+$spell
+	numpy
+	adfun
+$$
+
+$section Diagonal of the Hessian in a Range Direction$$
+
+$index hessian_diagonal$$
+$index hessian, diagonal$$
+$index diagonal, hessian$$
+$index sparse, hessian diagonal$$
+
+$head Syntax$$
+$icode%d% = %f%.hessian_diagonal(%x%, %w%)%$$
+
+$head Purpose$$
+This routine computes the diagonal of the Hessian of the weighted sum
+$latex \[
+	w_0 * F_0 (x) + \cdots + w_{m-1} * F_{m-1} (x)
+\] $$
+without forming the Hessian.
+Here $latex F : \B{R}^n \rightarrow \B{R}^m$$ is the 
+function corresponding to the $code adfun$$ object $cref/f/adfun/f/$$.
+
+$head f$$
+The object $icode f$$ must be an $cref adfun$$ object.
+We use $cref/level/adfun/f/level/$$ for the AD $cref ad$$ level of 
+this object.
+
+$head x$$
+The argument $icode x$$ is a $code numpy.array$$ with one dimension
+(i.e., a vector) with length equal to the domain size $cref/n/adfun/f/n/$$
+for the function $icode f$$.
+It specifies the argument value at which the derivative is computed.
+If the AD $cref/level/adfun/f/level/$$ for $icode f$$ is zero,
+all the elements of $icode x$$ must be either $code int$$ or instances
+of $code float$$.
+If the AD $cref/level/adfun/f/level/$$ for $icode f$$ is one,
+all the elements of $icode x$$ must be $code a_float$$ objects.
+
+$head w$$
+The argument $icode w$$ is a $code numpy.array$$ with one dimension
+with length equal to the range size $cref/m/adfun/f/m/$$
+and the same element type as $icode x$$.
+It specifies the weighting vector for the Hessian.
+
+$head d$$
+The return value $icode d$$ is a $code numpy.array$$ with one dimension
+and length $icode n$$.
+For $latex j = 0 , \ldots , n-1$$,
+$latex \[
+	d_j = w_0 * \partial_{j,j} F_0 (x) + \cdots 
+	+ w_{m-1} * \partial_{j,j} F_{m-1} (x)
+\] $$
+If the AD $cref/level/adfun/f/level/$$ for $icode f$$ is zero,
+all the elements of $icode d$$ will be instances of $code float$$.
+If the AD $cref/level/adfun/f/level/$$ for $icode f$$ is one,
+all the elements of $icode d$$ will be $code a_float$$ objects.
+
+$head Efficiency$$
+The first call for each $icode f$$ computes the sparsity pattern
+of the Hessian and a coloring of the domain components such that 
+components with the same color do not interact in the Hessian.
+The coloring is stored in $icode f$$ and reused by later calls.
+Each call then requires one zero order forward sweep,
+and for each color, 
+one first order forward sweep and one second order reverse sweep.
+If the Hessian is diagonal, only one color is necessary.
+If it is dense, $icode n$$ colors are necessary.
+
+$children%
+	example/hessian_diagonal.py
+%$$
+$head Example$$ 
+The file $cref hessian_diagonal.py$$ contains an example and test of
+this operation.
+
+$end
+---------------------------------------------------------------------------
+$begin stats$$
+$spell
+	numpy
+	adfun
+	dict
+	VecAD
+	var
+	op
+	arg
+	seq
+	taylor
+	condexp
+	arccos
+	arcsin
+	arctan
+	cosh
+	sinh
+	tanh
+	sqrt
+$$
+
+$section Operation Sequence Statistics$$
+
+$index stats$$
+$index tape, statistics$$
+$index statistics, tape$$
+$index operation sequence, size$$
+$index memory, tape$$
+
+$head Syntax$$
+$icode%s% = %f%.stats()%$$
+
+$head Purpose$$
+Returns a python $code dict$$ that describes the size of the operation
+sequence stored in $icode f$$, the memory it uses,
+and the types of operations that were recorded.
+This can be used to find the parts of a model that make its
+operation sequence large.
+
+$head f$$
+The object $icode f$$ must be an $cref adfun$$ object.
+
+$head s$$
+The return value $icode s$$ is a $code dict$$ with the following keys:
+$table
+$bold key$$ $cnext $bold value$$ $rnext
+$code n$$ $cnext 
+	domain size $cref/n/adfun/f/n/$$ $rnext
+$code m$$ $cnext 
+	range size $cref/m/adfun/f/m/$$ $rnext
+$code size_var$$ $cnext
+	number of variables in the operation sequence $rnext
+$code size_op$$ $cnext
+	number of operations in the operation sequence $rnext
+$code size_op_arg$$ $cnext
+	number of operation arguments in the operation sequence $rnext
+$code size_par$$ $cnext
+	number of parameters in the operation sequence $rnext
+$code size_text$$ $cnext
+	number of characters of text in the operation sequence $rnext
+$code size_VecAD$$ $cnext
+	number of VecAD indices in the operation sequence $rnext
+$code size_order$$ $cnext
+	number of Taylor coefficient orders currently stored $rnext
+$code op_seq_bytes$$ $cnext
+	number of bytes used by the operation sequence $rnext
+$code taylor_bytes$$ $cnext
+	number of bytes allocated for Taylor coefficients (see below) $rnext
+$code bytes$$ $cnext
+	sum of $code op_seq_bytes$$ and $code taylor_bytes$$ $rnext
+$code recorded_op$$ $cnext
+	histogram of recorded operations (if not optimized; see below) $rnext
+$code before_optimize$$ $cnext
+	sizes before optimization (see below)
+$tend
+
+$head recorded_op$$
+The value $icode%s%['recorded_op']%$$ is a $code dict$$ that maps
+an operation name to the number of times it was recorded using
+the $code a_float$$ ($code a2float$$) operators and functions
+between the call to $cref independent$$ and the creation of $icode f$$.
+Only operations with a variable operand, and hence recorded,
+are counted.
+The possible names are
+$code add$$, $code sub$$, $code mul$$, $code div$$, $code neg$$,
+$code pow$$, $code abs$$,
+$code arccos$$, $code arcsin$$, $code arctan$$, $code cos$$, $code cosh$$,
+$code exp$$, $code log$$, $code log10$$, $code sin$$, $code sinh$$, 
+$code sqrt$$, $code tan$$, $code tanh$$, $code condexp$$ and
+$code atomic$$ (see $cref linear_algebra$$).
+Names with a zero count are not included.
+Operations that CppAD records for itself are not counted;
+e.g., the operations that pass arguments and results to an atomic
+function, or operations that a CppAD routine records for conditional
+expressions.
+The histogram describes the recording, not the optimized operation 
+sequence, so after $cref optimize$$ it is moved to 
+$icode%s%['before_optimize']['recorded_op']%$$.
+
+$head taylor_bytes$$
+The value $icode%s%['taylor_bytes']%$$ is the number of bytes 
+allocated for the Taylor coefficients of every variable, 
+which depends on the capacity (see $cref capacity_order$$)
+and may be more than the $code size_order$$ orders that are stored.
+It also includes any forward mode sparsity pattern stored in $icode f$$.
+
+$head before_optimize$$
+If $icode%f%.optimize()%$$ has been called,
+$icode%s%['before_optimize']%$$ is a $code dict$$ with the keys
+$code size_var$$, $code size_op$$, $code size_op_arg$$, $code size_par$$ 
+and $code op_seq_bytes$$ and their values before the first optimization,
+and the key $code recorded_op$$ with the histogram above.
+The other values in $icode s$$ correspond to the current
+(optimized) operation sequence.
+Otherwise, $code before_optimize$$ is not a key in $icode s$$.
+
+$children%
+	example/stats.py
+%$$
+$head Example$$ 
+The file $cref stats.py$$ contains an example and test of this operation.
+
+$end
+---------------------------------------------------------------------------
+$begin counters$$
+$spell
+	adfun
+	dict
+	us
+	setup.py
+	bool
+	numpy
+	jacobian
+	vec
+	pycppad
+$$
+
+$section Instrumentation Counters$$
+
+$index counters$$
+$index reset_counters$$
+$index instrument, counters$$
+$index timing, adfun$$
+$index profile, adfun calls$$
+
+$head Syntax$$
+$icode%c% = %f%.counters()
+%$$
+$icode%f%.reset_counters()
+%$$
+$icode%c% = counters()
+%$$
+$codei%reset_counters()%$$
+
+$head Purpose$$
+Reports where the time goes in the calls that use $cref adfun$$ objects;
+i.e., how much is spent converting the numpy arguments to C++ vectors,
+how much in the CppAD sweeps, and how much converting the results 
+back to numpy arrays.
+
+$head Enabling$$
+These counters are only compiled into $code pycppad$$ when
+$code instrument$$ is $code True$$ in the 
+$cref/setup.py/install/Required Setup Information/$$ user settings.
+Otherwise the counting code is not compiled and has no cost,
+$icode%c%['enabled']%$$ is $code False$$, and it is the only key in 
+$icode c$$.
+
+$head f$$
+The object $icode f$$ must be an $cref adfun$$ object.
+The syntax $icode%f%.counters()%$$ returns the counters for 
+the calls that use $icode f$$ and $icode%f%.reset_counters()%$$
+sets them to zero.
+
+$head Global$$
+The syntax $codei%counters()%$$ returns the sum of the counters for
+all the $code adfun$$ objects and
+$codei%reset_counters()%$$ sets them to zero.
+Resetting the global counters does not affect the counters for
+a particular $icode f$$ and vice versa.
+
+$head c$$
+If the counters are enabled, the return value $icode c$$ is a 
+$code dict$$ with the following keys:
+$table
+$bold key$$ $cnext $bold value$$ $rnext
+$code enabled$$ $cnext
+	the $code bool$$ value $code True$$ $rnext
+$code call$$ $cnext
+	number of calls that have been counted $rnext
+$code convert_us$$ $cnext
+	microseconds converting arguments from python $rnext
+$code sweep_us$$ $cnext
+	microseconds in CppAD sweeps $rnext
+$code output_us$$ $cnext
+	microseconds creating the return values $rnext
+$code bytes$$ $cnext
+	bytes allocated for pycppad vectors and return arrays $rnext
+$code forward$$ $cnext
+	$icode%c%['forward'][%p%]%$$ is the number of 
+	forward sweeps of order $icode p$$ $rnext
+$code reverse$$ $cnext
+	$icode%c%['reverse'][%p%]%$$ is the number of
+	reverse sweeps that compute derivatives of order $icode p$$ 
+	Taylor coefficients
+$tend
+The times are measured using $code CppAD::elapsed_seconds$$,
+which has microsecond resolution, 
+so a phase that takes less than a microsecond may be counted as zero.
+The calls that are counted are the $icode f$$ methods that evaluate
+the function or its derivatives; e.g., 
+$cref forward$$, $cref reverse$$, $cref jacobian$$ and $cref hessian$$.
+
+$children%
+	example/counters.py
+%$$
+$head Example$$ 
+The file $cref counters.py$$ contains an example and test of this operation.
+
+$end
+---------------------------------------------------------------------------
+$begin memory$$
+$spell
+	adfun
+	dict
+	op
+	seq
+	taylor
+	pycppad
+	numpy
+	bool
+	CppAD
+	inuse
+$$
+
+$section Memory Accounting$$
+
+$index memory$$
+$index release_memory$$
+$index reset_peak_memory$$
+$index hold_memory$$
+$index peak, memory$$
+$index allocator, memory$$
+
+$head Syntax$$
+$icode%d% = %f%.memory()
+%$$
+$icode%d% = memory()
+%$$
+$icode%released% = release_memory()
+%$$
+$codei%reset_peak_memory()
+%$$
+$codei%hold_memory(%value%)%$$
+
+$head Purpose$$
+Reports how much memory is used by the operation sequences,
+the Taylor coefficients, and the vectors $code pycppad$$ uses to convert
+between $code numpy$$ arrays and C++.
+All of this memory, except for the return values, 
+is allocated using the CppAD $code thread_alloc$$ memory allocator.
+
+$head f$$
+The object $icode f$$ must be an $cref adfun$$ object.
+The return value $icode%d% = %f%.memory()%$$ is a $code dict$$ with the
+following keys:
+$table
+$bold key$$ $cnext $bold value$$ $rnext
+$code op_seq_bytes$$ $cnext
+	bytes used by the operation sequence $rnext
+$code taylor_bytes$$ $cnext
+	bytes allocated for the Taylor coefficients; 
+	see $cref/taylor_bytes/stats/taylor_bytes/$$ $rnext
+$code bytes$$ $cnext
+	sum of $code op_seq_bytes$$ and $code taylor_bytes$$ $rnext
+$code peak_bytes$$ $cnext
+	largest value of $code bytes$$ since $icode f$$ was created
+$tend
+
+$head memory$$
+The return value $icode%d% = memory()%$$ is a $code dict$$ with the 
+following keys:
+$table
+$bold key$$ $cnext $bold value$$ $rnext
+$code inuse$$ $cnext
+	bytes in use for all threads $rnext
+$code available$$ $cnext
+	bytes held by the allocator for later use $rnext
+$code peak_inuse$$ $cnext
+	sum of the peak bytes in use for each thread $rnext
+$code scratch$$ $cnext
+	bytes in use for the conversion vectors $rnext
+$code freelist$$ $cnext
+	bytes held for reuse by new $code a_float$$ and $code a2float$$ objects
+	$rnext
+$code thread$$ $cnext
+	list with a $code dict$$ for each thread
+$tend
+The element $icode%d%['thread'][%t%]%$$ has the keys
+$code inuse$$, $code available$$, $code peak_inuse$$,
+$code scratch$$ and $code peak_scratch$$
+with the corresponding values for thread $icode t$$.
+There is only one thread unless CppAD is in parallel mode.
+
+$head Peak Values$$
+The peak values are sampled when the memory functions are called, 
+when an $code adfun$$ object is created or optimized,
+and when its function or derivative values are computed.
+Memory that is allocated and freed within one of these calls
+is not included.
+The function $codei%reset_peak_memory()%$$ sets the peak values for 
+each thread to the corresponding current values
+(it does not change the $icode%f%.memory()%$$ peak values).
+
+$head release_memory$$
+Memory that is freed is held by the allocator (for quick reuse by the
+same thread) if $codei%hold_memory(True)%$$ has been called, or if
+CppAD is in parallel mode.
+The $code a_float$$ and $code a2float$$ objects that are freed 
+(for example the temporaries created while recording)
+are held on a freelist for reuse by the next such object.
+The function $code release_memory$$ returns the memory being held for
+every thread, and on the freelists, to the system; 
+$icode released$$ is the number of bytes that were released.
+
+$head hold_memory$$
+The argument $icode value$$ is a $code bool$$.
+If it is true, freed memory is held for reuse (this is faster).
+If it is false, freed memory is returned to the system
+(this is the default).
+
+$children%
+	example/memory.py
+%$$
+$head Example$$ 
+The file $cref memory.py$$ contains an example and test of this operation.
+
+$end
+---------------------------------------------------------------------------
+$begin capacity_order$$
+$spell
+	adfun
+	bool
+	jacobian
+	hessian
+	jac
+	hess
+	Taylor
+$$
+
+$section Taylor Coefficient Capacity$$
+
+$index capacity_order$$
+$index capacity_policy$$
+$index Taylor coefficient, memory$$
+$index memory, Taylor coefficient$$
+
+$head Syntax$$
+$icode%f%.capacity_order(%c%)
+%$$
+$icode%f%.capacity_policy(%drop%, %reserve%)%$$
+
+$head Purpose$$
+Each $cref forward$$ call of order $icode p$$ stores the Taylor coefficients
+of orders zero through $icode p$$ for every variable in $icode f$$ and
+they are kept until $icode f$$ is deleted.
+These functions control the memory used to store them; 
+see $cref/taylor_bytes/memory/f/$$.
+
+$head f$$
+The object $icode f$$ must be an $cref adfun$$ object.
+
+$head c$$
+The argument $icode c$$ is a non-negative $code int$$.
+The memory for Taylor coefficients in $icode f$$ is changed so that
+it holds exactly $icode c$$ orders.
+If $icode c$$ is less than the number of orders currently stored,
+the orders $icode c$$ and higher are lost.
+If $icode c$$ is zero, all of the Taylor coefficients are lost
+and the next call to $cref forward$$ must have order zero.
+If $icode c$$ is greater, memory is reserved so that forward sweeps of
+order less than $icode c$$ do not need to allocate more memory.
+
+$head drop$$
+The argument $icode drop$$ is a $code bool$$.
+If it is true, the Taylor coefficients in $icode f$$ are dropped,
+as if $icode%f%.capacity_order(0)%$$ were called,
+at the end of each call to
+$cref jacobian$$, $cref hessian$$, $cref value_and_grad$$, 
+$cref/value_jac_hess/value_and_grad/$$,
+$cref hessian_vector$$ and $cref hessian_diagonal$$.
+This is useful when there are many $code adfun$$ objects and
+each one is evaluated occasionally.
+
+$head reserve$$
+The argument $icode reserve$$ is a positive $code int$$.
+If it is greater than one, $icode%f%.capacity_order(%reserve%)%$$ is
+called before the next zero order $icode%f%.forward%$$ call,
+and before the next one after coefficients are dropped.
+This is useful when $icode f$$ will be used for forward sweeps up to
+order $icode%reserve%-1%$$.
+
+$head Default$$
+The default policy for an $code adfun$$ object is 
+$icode drop$$ false and $icode reserve$$ one.
+
+$children%
+	example/capacity_order.py
+%$$
+$head Example$$ 
+The file $cref capacity_order.py$$ contains an example and test of 
+this operation.
+
+$end
+---------------------------------------------------------------------------
+$begin forward_points$$
+$spell
+	adfun
+	numpy
+	dtype
+	CppAD
+	SIMD
+	condexp
+	Taylor
+$$
+
+$section Function Values at Many Points$$
+
+$index forward_points$$
+$index points, function values$$
+
+$head Syntax$$
+$icode%Y% = %f%.forward_points(%X%)%$$
+
+$head Purpose$$
+Evaluates the function $latex F : \B{R}^n \rightarrow \B{R}^m$$
+corresponding to the $cref adfun$$ object $icode f$$ at many points
+in one call.
+This is a C++ loop that does one zero order forward sweep for each point;
+it is not a batched (vectorized) evaluation.
+It only avoids the python call and the array conversions for each point
+that result from calling $cref/forward(0, x)/forward/$$ in a python loop.
+
+$head X$$
+The argument $icode X$$ is a $code numpy.array$$ with two dimensions,
+$icode k$$ rows and $icode n$$ columns.
+Each row of $icode X$$ is a point at which $latex F$$ is evaluated.
+The elements of $icode X$$ have the same type as for 
+$cref/x_p/forward/x_p/$$ in a zero order forward call.
+
+$head Y$$
+The result $icode Y$$ is a $code numpy.array$$ with $icode k$$ rows and 
+$icode m$$ columns and its $th i$$ row is $latex F(x)$$ where
+$latex x$$ is the $th i$$ row of $icode X$$.
+
+$head Taylor Coefficients$$
+After this call, the zero order Taylor coefficients stored in $icode f$$
+correspond to the last row of $icode X$$
+(if $icode k$$ is zero they are not changed).
+
+$head Efficiency$$
+The time for each sweep is the same as for $code forward(0, x)$$,
+so the savings are largest when the operation sequence is short.
+CppAD can not change the base type for an $code adfun$$ object
+so packing several points in one SIMD value is not available.
+Conditional expressions, see $cref condexp$$, are evaluated separately
+for each point.
+The $code forward_points$$ case in $code test_speed.py$$ compares this
+loop with a python loop of $code forward(0, x)$$ calls.
+
+$children%
+	example/forward_points.py
+%$$
+$head Example$$ 
+The file $cref forward_points.py$$ contains an example and test of 
+this operation.
+
 $end
 ---------------------------------------------------------------------------
 */
 # include "adfun.hpp"
 # include "vector.hpp"
 # include "vec2array.hpp"
+# include "op_count.hpp"
 
 namespace pycppad {
 	// -------------------------------------------------------------
+	// Number of columns in an argument that is either a vector (one column)
+	// or a matrix with nr rows. The flag matrix is set to true for a matrix.
+	static size_t n_column(array& a, size_t nr, bool& matrix, const char* msg)
+	{	PyArrayObject* p = reinterpret_cast<PyArrayObject*>(a.ptr());
+		int            nd   = PyArray_NDIM(p);
+		npy_intp*      dims = PyArray_DIMS(p);
+		PYCPPAD_ASSERT( nd == 1 || nd == 2, msg);
+		PYCPPAD_ASSERT( static_cast<size_t>( dims[0] ) == nr, msg);
+		matrix = (nd == 2);
+		if( ! matrix )
+			return 1;
+		return static_cast<size_t>( dims[1] );
+	}
+	// elements of a vector or matrix argument in row major order
+	static array ravel(array& a)
+	{	return extract<array>( a.attr("ravel")() ); }
+	// -------------------------------------------------------------
 
 	// constructor for python class ADFun<Base>
 	template <class Base>
@@ -450,6 +1327,26 @@ namespace pycppad {
 		vec< CppAD::AD<Base> > y_vec(y_array);
 
 		f_.Dependent(x_vec, y_vec);
+		taylor_id_ = 0;
+		n_color_   = 0;
+
+		// operations counted since the corresponding call to independent
+		op_count_ = op_count<Base>();
+		op_count_.resize(
+			std::max(op_count_.size(), size_t(number_op_type)), 0
+		);
+		set_recording(recording_level<Base>(), false);
+
+		profile_ = false;
+		for(size_t k = 0; k < 2; k++)
+		{	profile_seconds_[k] = 0.;
+			profile_sweep_[k]   = 0;
+		}
+		peak_bytes_ = 0;
+		drop_       = false;
+		reserve_    = 1;
+		reserved_   = true;
+		Sample();
 	}
 
 	// Domain
@@ -465,12 +1362,74 @@ namespace pycppad {
 	// Forward
 	template <class Base>
 	array ADFun<Base>::Forward(int p, array& xp)
-	{	size_t    p_sz(p);
+	{	PYCPPAD_PROBE(counters_);
+		size_t    p_sz(p);
 		vec<Base> xp_vec(xp);
+		PYCPPAD_PROBE_PHASE(sweep);
+		if( p == 0 && ! reserved_ )
+		{	f_.capacity_order(reserve_);
+			reserved_ = true;
+		}
+		double start = 0.;
+		if( profile_ )
+			start = CppAD::elapsed_seconds();
 		vec<Base> result = f_.Forward(p_sz, xp_vec);
+		if( profile_ )
+		{	profile_seconds_[0] += CppAD::elapsed_seconds() - start;
+			profile_sweep_[0]++;
+		}
+		PYCPPAD_PROBE_FORWARD(p_sz);
+		if( p == 0 )
+			taylor_id_++;
+		Sample();
+		PYCPPAD_PROBE_PHASE(output);
 		return vec2array(result);
 	}
 
+	// ForwardPoints
+	template <class Base>
+	array ADFun<Base>::ForwardPoints(array& X)
+	{	PYCPPAD_PROBE(counters_);
+		size_t n = f_.Domain();
+		size_t m = f_.Range();
+		PyArrayObject* p = reinterpret_cast<PyArrayObject*>( X.ptr() );
+		PYCPPAD_ASSERT(
+			PyArray_NDIM(p) == 2 && 
+			static_cast<size_t>( PyArray_DIMS(p)[1] ) == n,
+			"forward_points: X is not a matrix with n columns"
+		);
+		size_t    k = static_cast<size_t>( PyArray_DIMS(p)[0] );
+		array     X_array = ravel(X);
+		vec<Base> X_vec(X_array);
+		vec<Base> x_vec(n);
+		vec<Base> Y_vec(k * m);
+		PYCPPAD_PROBE_PHASE(sweep);
+		if( ! reserved_ )
+		{	f_.capacity_order(reserve_);
+			reserved_ = true;
+		}
+		double start = 0.;
+		if( profile_ )
+			start = CppAD::elapsed_seconds();
+		size_t i, j, ell;
+		for(ell = 0; ell < k; ell++)
+		{	for(j = 0; j < n; j++)
+				x_vec[j] = X_vec[ell * n + j];
+			vec<Base> y_vec = f_.Forward(0, x_vec);
+			PYCPPAD_PROBE_FORWARD(0);
+			for(i = 0; i < m; i++)
+				Y_vec[ell * m + i] = y_vec[i];
+		}
+		if( profile_ )
+		{	profile_seconds_[0] += CppAD::elapsed_seconds() - start;
+			profile_sweep_[0]   += k;
+		}
+		taylor_id_++;
+		Sample();
+		PYCPPAD_PROBE_PHASE(output);
+		return vec2array(k, m, Y_vec);
+	}
+
 # ifdef NDEBUG
 	template <class Base>
 	int ADFun<Base>::CompareChange(void)
@@ -494,9 +1453,21 @@ namespace pycppad {
 	// Reverse
 	template <class Base>
 	array ADFun<Base>::Reverse(int p, array& w)
-	{	size_t    p_sz(p);
+	{	PYCPPAD_PROBE(counters_);
+		size_t    p_sz(p);
 		vec<Base> w_vec(w);
+		PYCPPAD_PROBE_PHASE(sweep);
+		double start = 0.;
+		if( profile_ )
+			start = CppAD::elapsed_seconds();
 		vec<Base> dw_vec = f_.Reverse(p_sz, w_vec);
+		if( profile_ )
+		{	profile_seconds_[1] += CppAD::elapsed_seconds() - start;
+			profile_sweep_[1]++;
+		}
+		PYCPPAD_PROBE_REVERSE(p_sz - 1);
+		Sample();
+		PYCPPAD_PROBE_PHASE(output);
 		size_t n = f_.Domain();
 		vec<Base> result(n);
 		for(size_t j = 0; j < n; j++)
@@ -507,26 +1478,546 @@ namespace pycppad {
 	// Jacobian
 	template <class Base>
 	array ADFun<Base>::Jacobian(array& x)
-	{	vec<Base> x_vec(x);
+	{	PYCPPAD_PROBE(counters_);
+		size_t n = f_.Domain();
+		size_t m = f_.Range();
+		vec<Base> x_vec(x);
+		PYCPPAD_PROBE_PHASE(sweep);
 		vec<Base> result = f_.Jacobian(x_vec);
-		// Kludge: return a vector which is reshaped by cppad.py
-		return vec2array(result);
+		taylor_id_++;
+# ifdef PYCPPAD_INSTRUMENT
+		// sweeps done by CppAD::ADFun<Base>::Jacobian
+		PYCPPAD_PROBE_FORWARD(0);
+		for(size_t k = 0; k < std::min(n, m); k++)
+		{	if( n <= m )
+				PYCPPAD_PROBE_FORWARD(1);
+			else	PYCPPAD_PROBE_REVERSE(0);
+		}
+# endif
+		Sample();
+		Drop();
+		PYCPPAD_PROBE_PHASE(output);
+		return vec2array(m, n, result);
 	}
 
 	// Hessian
 	template <class Base>
 	array ADFun<Base>::Hessian(array& x, array& w)
-	{	vec<Base> x_vec(x);
+	{	PYCPPAD_PROBE(counters_);
+		size_t n = f_.Domain();
+		vec<Base> x_vec(x);
 		vec<Base> w_vec(w);
+		PYCPPAD_PROBE_PHASE(sweep);
 		vec<Base> result = f_.Hessian(x_vec, w_vec);
-		// Kludge: return a vector which is reshaped by cppad.py
-		return vec2array(result);
+		taylor_id_++;
+# ifdef PYCPPAD_INSTRUMENT
+		// sweeps done by CppAD::ADFun<Base>::Hessian
+		PYCPPAD_PROBE_FORWARD(0);
+		for(size_t j = 0; j < n; j++)
+		{	PYCPPAD_PROBE_FORWARD(1);
+			PYCPPAD_PROBE_REVERSE(1);
+		}
+# endif
+		Sample();
+		Drop();
+		PYCPPAD_PROBE_PHASE(output);
+		return vec2array(n, n, result);
+	}
+
+	// sizes of the operation sequence that optimize changes
+	template <class Base>
+	static CppAD::vector<size_t> op_seq_size(CppAD::ADFun<Base>& f)
+	{	CppAD::vector<size_t> size(5);
+		size[0] = f.size_var();
+		size[1] = f.size_op();
+		size[2] = f.size_op_arg();
+		size[3] = f.size_par();
+		size[4] = f.size_op_seq();
+		return size;
+	}
+	static boost::python::dict op_seq_size_dict(
+		const CppAD::vector<size_t>& size)
+	{	boost::python::dict result;
+		result["size_var"]     = size[0];
+		result["size_op"]      = size[1];
+		result["size_op_arg"]  = size[2];
+		result["size_par"]     = size[3];
+		result["op_seq_bytes"] = size[4];
+		return result;
 	}
 
 	// optimize
 	template <class Base>
-	void ADFun<Base>::optimize(void)
-	{	f_.optimize(); }
+	boost::python::dict ADFun<Base>::optimize(const std::string& options)
+	{	CppAD::vector<size_t> before = op_seq_size(f_);
+		if( options == "" )
+			f_.optimize();
+		else
+		{
+# ifdef PYCPPAD_OPTIMIZE_OPTIONS
+			f_.optimize(options);
+# else
+			throw not_implemented(
+				"optimize(options): this CppAD does not support options; "
+				"see optimize_options in setup.py"
+			);
+# endif
+		}
+		// CppAD frees the Taylor coefficients during the optimization
+		taylor_id_++;
+		reserved_ = false;
+		if( before_optimize_.size() == 0 )
+			before_optimize_ = before;
+		Sample();
+		boost::python::dict result;
+		result["before"] = op_seq_size_dict(before);
+		result["after"]  = op_seq_size_dict( op_seq_size(f_) );
+		return result;
+	}
+
+	// ValueAndGrad
+	template <class Base>
+	tuple ADFun<Base>::ValueAndGrad(array& x)
+	{	PYCPPAD_ASSERT(
+			f_.Range() == 1,
+			"value_and_grad: range size for f is not one"
+		);
+		PYCPPAD_PROBE(counters_);
+		vec<Base> x_vec(x);
+		PYCPPAD_PROBE_PHASE(sweep);
+		vec<Base> y_vec = f_.Forward(0, x_vec);
+		PYCPPAD_PROBE_FORWARD(0);
+		taylor_id_++;
+		vec<Base> w_vec(1);
+		w_vec[0] = Base(1.);
+		vec<Base> g_vec = f_.Reverse(1, w_vec);
+		PYCPPAD_PROBE_REVERSE(0);
+		Sample();
+		Drop();
+		PYCPPAD_PROBE_PHASE(output);
+		return make_tuple(y_vec[0], vec2array(g_vec));
+	}
+
+	// ValueJacHess
+	template <class Base>
+	tuple ADFun<Base>::ValueJacHess(array& x, array& w)
+	{	PYCPPAD_PROBE(counters_);
+		size_t n = f_.Domain();
+		size_t m = f_.Range();
+		vec<Base> x_vec(x);
+		vec<Base> w_vec(w);
+		PYCPPAD_ASSERT(
+			w_vec.size() == m,
+			"value_jac_hess: size of w not equal range size for f"
+		);
+		PYCPPAD_PROBE_PHASE(sweep);
+		vec<Base> y_vec = f_.Forward(0, x_vec);
+		PYCPPAD_PROBE_FORWARD(0);
+		taylor_id_++;
+
+		// The first order forward sweep in direction e_j is column j of
+		// the Jacobian and also the direction for column j of the Hessian.
+		vec<Base> u_vec(n);
+		vec<Base> J_vec(m * n);
+		vec<Base> H_vec(n * n);
+		size_t i, j, k;
+		for(j = 0; j < n; j++)
+			u_vec[j] = Base(0.);
+		for(j = 0; j < n; j++)
+		{	u_vec[j] = Base(1.);
+			vec<Base> dy_vec = f_.Forward(1, u_vec);
+			PYCPPAD_PROBE_FORWARD(1);
+			for(i = 0; i < m; i++)
+				J_vec[i * n + j] = dy_vec[i];
+			vec<Base> ddw_vec = f_.Reverse(2, w_vec);
+			PYCPPAD_PROBE_REVERSE(1);
+			for(k = 0; k < n; k++)
+				H_vec[k * n + j] = ddw_vec[k * 2 + 1];
+			u_vec[j] = Base(0.);
+		}
+		Sample();
+		Drop();
+		PYCPPAD_PROBE_PHASE(output);
+		return make_tuple(
+			vec2array(y_vec),
+			vec2array(m, n, J_vec),
+			vec2array(n, n, H_vec)
+		);
+	}
+
+	// HessianVector
+	template <class Base>
+	array ADFun<Base>::HessianVector(array& x, array& w, array& v)
+	{	PYCPPAD_PROBE(counters_);
+		size_t n = f_.Domain();
+		size_t m = f_.Range();
+		bool   matrix;
+		size_t k = n_column(v, n, matrix,
+			"hessian_vector: v is not a vector or matrix with n rows"
+		);
+		vec<Base> x_vec(x);
+		vec<Base> w_vec(w);
+		array     v_array = ravel(v);
+		vec<Base> v_vec(v_array);
+		PYCPPAD_ASSERT(
+			w_vec.size() == m,
+			"hessian_vector: size of w not equal range size for f"
+		);
+
+		// zero order Taylor coefficients are shared by all the directions
+		PYCPPAD_PROBE_PHASE(sweep);
+		f_.Forward(0, x_vec);
+		PYCPPAD_PROBE_FORWARD(0);
+		taylor_id_++;
+		vec<Base> u_vec(n);
+		vec<Base> hv_vec(n * k);
+		size_t j, ell;
+		for(ell = 0; ell < k; ell++)
+		{	for(j = 0; j < n; j++)
+				u_vec[j] = v_vec[j * k + ell];
+			f_.Forward(1, u_vec);
+			PYCPPAD_PROBE_FORWARD(1);
+			vec<Base> ddw_vec = f_.Reverse(2, w_vec);
+			PYCPPAD_PROBE_REVERSE(1);
+			for(j = 0; j < n; j++)
+				hv_vec[j * k + ell] = ddw_vec[j * 2 + 1];
+		}
+		Sample();
+		Drop();
+		PYCPPAD_PROBE_PHASE(output);
+		if( ! matrix )
+			return vec2array(hv_vec);
+		return vec2array(n, k, hv_vec);
+	}
+
+	// ColorHessianDiagonal
+	// Two domain components j and k can share a color when the Hessian
+	// of the sum of all the range components is structurally zero at (j, k);
+	// i.e., one sweep in the sum of their directions gives both diagonals.
+	template <class Base>
+	void ADFun<Base>::ColorHessianDiagonal(void)
+	{	typedef CppAD::vector< std::set<size_t> > set_vec;
+		size_t n = f_.Domain();
+		size_t m = f_.Range();
+		size_t i, j, c;
+
+		// sparsity pattern for the Hessian of the sum of all components
+		set_vec r(n);
+		for(j = 0; j < n; j++)
+			r[j].insert(j);
+		f_.ForSparseJac(n, r);
+		set_vec s(1);
+		for(i = 0; i < m; i++)
+			s[0].insert(i);
+		set_vec h = f_.RevSparseHes(n, s);
+
+		// greedy coloring, mark[c] == j means color c is used by a
+		// component that is connected to j
+		CppAD::vector<size_t> mark(n);
+		for(c = 0; c < n; c++)
+			mark[c] = n;
+		color_.resize(n);
+		n_color_ = 0;
+		std::set<size_t>::const_iterator itr;
+		for(j = 0; j < n; j++)
+		{	for(itr = h[j].begin(); itr != h[j].end(); itr++)
+			{	if( *itr < j )
+					mark[ color_[*itr] ] = j;
+			}
+			c = 0;
+			while( c < n_color_ && mark[c] == j )
+				c++;
+			color_[j] = c;
+			if( c == n_color_ )
+				n_color_++;
+		}
+	}
+
+	// HessianDiagonal
+	template <class Base>
+	array ADFun<Base>::HessianDiagonal(array& x, array& w)
+	{	PYCPPAD_PROBE(counters_);
+		size_t n = f_.Domain();
+		size_t m = f_.Range();
+		vec<Base> x_vec(x);
+		vec<Base> w_vec(w);
+		PYCPPAD_ASSERT(
+			w_vec.size() == m,
+			"hessian_diagonal: size of w not equal range size for f"
+		);
+		PYCPPAD_PROBE_PHASE(sweep);
+		if( n_color_ == 0 )
+			ColorHessianDiagonal();
+
+		f_.Forward(0, x_vec);
+		PYCPPAD_PROBE_FORWARD(0);
+		taylor_id_++;
+		vec<Base> u_vec(n);
+		vec<Base> d_vec(n);
+		size_t j, c;
+		for(c = 0; c < n_color_; c++)
+		{	for(j = 0; j < n; j++)
+			{	if( color_[j] == c )
+					u_vec[j] = Base(1.);
+				else	u_vec[j] = Base(0.);
+			}
+			f_.Forward(1, u_vec);
+			PYCPPAD_PROBE_FORWARD(1);
+			vec<Base> ddw_vec = f_.Reverse(2, w_vec);
+			PYCPPAD_PROBE_REVERSE(1);
+			for(j = 0; j < n; j++)
+			{	if( color_[j] == c )
+					d_vec[j] = ddw_vec[j * 2 + 1];
+			}
+		}
+		Sample();
+		Drop();
+		PYCPPAD_PROBE_PHASE(output);
+		return vec2array(d_vec);
+	}
+
+	// JacVec: uses the current zero order Taylor coefficients
+	template <class Base>
+	array ADFun<Base>::JacVec(array& v)
+	{	PYCPPAD_PROBE(counters_);
+		size_t n = f_.Domain();
+		size_t m = f_.Range();
+		bool   matrix;
+		size_t k = n_column(v, n, matrix,
+			"matvec: v is not a vector or matrix with n rows"
+		);
+		array     v_array = ravel(v);
+		vec<Base> v_vec(v_array);
+		vec<Base> u_vec(n);
+		vec<Base> jv_vec(m * k);
+		PYCPPAD_PROBE_PHASE(sweep);
+		size_t i, j, ell;
+		for(ell = 0; ell < k; ell++)
+		{	for(j = 0; j < n; j++)
+				u_vec[j] = v_vec[j * k + ell];
+			vec<Base> dy_vec = f_.Forward(1, u_vec);
+			PYCPPAD_PROBE_FORWARD(1);
+			for(i = 0; i < m; i++)
+				jv_vec[i * k + ell] = dy_vec[i];
+		}
+		Sample();
+		PYCPPAD_PROBE_PHASE(output);
+		if( ! matrix )
+			return vec2array(jv_vec);
+		return vec2array(m, k, jv_vec);
+	}
+
+	// VecJac: uses the current zero order Taylor coefficients
+	template <class Base>
+	array ADFun<Base>::VecJac(array& u)
+	{	PYCPPAD_PROBE(counters_);
+		size_t n = f_.Domain();
+		size_t m = f_.Range();
+		bool   matrix;
+		size_t k = n_column(u, m, matrix,
+			"rmatvec: u is not a vector or matrix with m rows"
+		);
+		array     u_array = ravel(u);
+		vec<Base> u_vec(u_array);
+		vec<Base> w_vec(m);
+		vec<Base> uj_vec(n * k);
+		PYCPPAD_PROBE_PHASE(sweep);
+		size_t i, j, ell;
+		for(ell = 0; ell < k; ell++)
+		{	for(i = 0; i < m; i++)
+				w_vec[i] = u_vec[i * k + ell];
+			vec<Base> dw_vec = f_.Reverse(1, w_vec);
+			PYCPPAD_PROBE_REVERSE(0);
+			for(j = 0; j < n; j++)
+				uj_vec[j * k + ell] = dw_vec[j];
+		}
+		Sample();
+		PYCPPAD_PROBE_PHASE(output);
+		if( ! matrix )
+			return vec2array(uj_vec);
+		return vec2array(n, k, uj_vec);
+	}
+
+	// Derivative
+	template <class Base>
+	array ADFun<Base>::Derivative(const std::string& kind, array& x_array)
+	{	derivative_kind k;
+		if( kind == "gradient" )
+			k = derivative_gradient;
+		else if( kind == "jacobian" )
+			k = derivative_jacobian;
+		else if( kind == "hessian_vector" )
+			k = derivative_hessian_vector;
+		else	throw pycppad::exception(
+			"derivative_adfun: kind is not gradient, jacobian, "
+			"or hessian_vector"
+		);
+		size_t n  = f_.Domain();
+		size_t m  = f_.Range();
+		PYCPPAD_ASSERT( k == derivative_jacobian || m == 1,
+			"derivative_adfun: range of f is not one for this kind"
+		);
+		size_t nx = n;
+		size_t ny = n;
+		if( k == derivative_hessian_vector )
+			nx = 2 * n;
+		if( k == derivative_jacobian )
+			ny = m * n;
+		vec< CppAD::AD<Base> > ax(x_array);
+		PYCPPAD_ASSERT( ax.size() == nx,
+			"derivative_adfun: argument has the wrong size"
+		);
+		if( derivative_.find(k) == derivative_.end() )
+			derivative_[k].reset( new atomic_derivative<Base>(f_, k) );
+		vec< CppAD::AD<Base> > ay(ny);
+		(*derivative_[k])(ax, ay);
+		count_op<Base>(op_atomic, true);
+		return vec2array(ay);
+	}
+
+	// TaylorId
+	template <class Base>
+	int ADFun<Base>::TaylorId(void)
+	{	return taylor_id_; }
+
+	// Stats
+	template <class Base>
+	boost::python::dict ADFun<Base>::Stats(void)
+	{	using boost::python::dict;
+		size_t taylor_bytes = f_.Memory() - f_.size_op_seq();
+		dict result;
+		result["n"]            = f_.Domain();
+		result["m"]            = f_.Range();
+		result["size_var"]     = f_.size_var();
+		result["size_op"]      = f_.size_op();
+		result["size_op_arg"]  = f_.size_op_arg();
+		result["size_par"]     = f_.size_par();
+		result["size_text"]    = f_.size_text();
+		result["size_VecAD"]   = f_.size_VecAD();
+		result["size_order"]   = f_.size_order();
+		result["op_seq_bytes"] = f_.size_op_seq();
+		result["taylor_bytes"] = taylor_bytes;
+		result["bytes"]        = f_.size_op_seq() + taylor_bytes;
+		// the histogram describes the recording, not an optimized sequence
+		if( before_optimize_.size() == 0 )
+			result["recorded_op"] = op_count2dict(op_count_);
+		else
+		{	dict before = op_seq_size_dict(before_optimize_);
+			before["recorded_op"]     = op_count2dict(op_count_);
+			result["before_optimize"] = before;
+		}
+		return result;
+	}
+
+	// Counters
+	template <class Base>
+	boost::python::dict ADFun<Base>::Counters(void)
+	{
+# ifdef PYCPPAD_INSTRUMENT
+		return counters_.as_dict();
+# else
+		return counters_disabled();
+# endif
+	}
+
+	// ResetCounters
+	template <class Base>
+	void ADFun<Base>::ResetCounters(void)
+	{
+# ifdef PYCPPAD_INSTRUMENT
+		counters_.reset();
+# endif
+	}
+
+	// Profile
+	template <class Base>
+	void ADFun<Base>::Profile(bool on)
+	{	if( on && ! profile_ )
+		{	for(size_t k = 0; k < 2; k++)
+			{	profile_seconds_[k] = 0.;
+				profile_sweep_[k]   = 0;
+			}
+		}
+		profile_ = on;
+	}
+
+	// CapacityOrder
+	template <class Base>
+	void ADFun<Base>::CapacityOrder(int c)
+	{	PYCPPAD_ASSERT(
+			c >= 0,
+			"capacity_order: c is less than zero"
+		);
+		size_t c_sz(c);
+		f_.capacity_order(c_sz);
+		if( c_sz == 0 )
+			taylor_id_++;
+		reserved_ = c_sz >= reserve_;
+		Sample();
+	}
+
+	// CapacityPolicy
+	template <class Base>
+	void ADFun<Base>::CapacityPolicy(bool drop, int reserve)
+	{	PYCPPAD_ASSERT(
+			reserve >= 1,
+			"capacity_policy: reserve is less than one"
+		);
+		drop_     = drop;
+		reserve_  = static_cast<size_t>(reserve);
+		reserved_ = reserve_ <= 1;
+	}
+
+	// Drop: apply the drop part of the capacity policy
+	template <class Base>
+	void ADFun<Base>::Drop(void)
+	{	if( drop_ )
+		{	f_.capacity_order(0);
+			taylor_id_++;
+			reserved_ = false;
+		}
+	}
+
+	// Sample: update the peak memory values
+	template <class Base>
+	void ADFun<Base>::Sample(void)
+	{	// CppAD Memory includes the Taylor coefficient capacity
+		size_t bytes = f_.Memory();
+		if( peak_bytes_ < bytes )
+			peak_bytes_ = bytes;
+		sample_memory();
+	}
+
+	// Memory
+	template <class Base>
+	boost::python::dict ADFun<Base>::Memory(void)
+	{	size_t taylor_bytes = f_.Memory() - f_.size_op_seq();
+		Sample();
+		boost::python::dict result;
+		result["op_seq_bytes"] = f_.size_op_seq();
+		result["taylor_bytes"] = taylor_bytes;
+		result["bytes"]        = f_.size_op_seq() + taylor_bytes;
+		result["peak_bytes"]   = peak_bytes_;
+		return result;
+	}
+
+	// ProfileData
+	template <class Base>
+	boost::python::dict ADFun<Base>::ProfileData(void)
+	{	using boost::python::dict;
+		dict cost;
+		for(size_t i = 0; i < number_op_type; i++)
+			cost[ op_type_name[i] ] = op_type_cost[i];
+		dict result;
+		result["profile"]         = profile_;
+		result["forward_seconds"] = profile_seconds_[0];
+		result["reverse_seconds"] = profile_seconds_[1];
+		result["forward_sweeps"]  = profile_sweep_[0];
+		result["reverse_sweeps"]  = profile_sweep_[1];
+		result["count"]           = op_count2label_dict(op_count_);
+		result["cost"]            = cost;
+		return result;
+	}
 
 	// -------------------------------------------------------------
 	// instantiate instances of ADFun<Base>
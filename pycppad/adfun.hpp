@@ -2,6 +2,10 @@
 # define PYCPPAD_ADFUN_INCLUDED
 
 # include "environment.hpp"
+# include "instrument.hpp"
+# include "memory.hpp"
+# include "atomic.hpp"
+# include <map>
 
 namespace pycppad {
 	// -------------------------------------------------------------
@@ -10,6 +14,42 @@ namespace pycppad {
 	class ADFun{
 	private:
 		CppAD::ADFun<Base> f_;
+		// changes each time the zero order Taylor coefficients may change
+		int taylor_id_;
+		// coloring of the domain used by HessianDiagonal (n_color_ is zero
+		// until the coloring has been computed)
+		size_t                n_color_;
+		CppAD::vector<size_t> color_;
+		void ColorHessianDiagonal(void);
+		// operations recorded through python for each label and op_type
+		std::vector<size_t> op_count_;
+		// Forward and Reverse timing while profiling is on
+		// (index zero is for Forward and index one for Reverse)
+		bool   profile_;
+		double profile_seconds_[2];
+		size_t profile_sweep_[2];
+		// largest value of the bytes reported by Memory since construction
+		size_t peak_bytes_;
+		void   Sample(void);
+		// capacity policy: drop_ is true if Taylor coefficients are
+		// dropped after the derivative drivers, reserve_ is the capacity
+		// set before a zero order forward sweep, and reserved_ is true
+		// if the current capacity is known to be at least reserve_
+		bool   drop_;
+		size_t reserve_;
+		bool   reserved_;
+		void   Drop(void);
+		// tape size before the first call to optimize (empty until then)
+		CppAD::vector<size_t> before_optimize_;
+		// atomic functions recorded by Derivative for each kind (they are
+		// used by the derivative function objects so this object must
+		// not be deleted before them)
+		std::map< int, boost::shared_ptr< atomic_derivative<Base> > >
+			derivative_;
+# ifdef PYCPPAD_INSTRUMENT
+		// instrumentation counters for the calls using this object
+		counters counters_;
+# endif
 	public:
 		// python constructor call
 		ADFun(array& x_array, array& y_array);
@@ -18,11 +58,28 @@ namespace pycppad {
 		int   Domain(void);
 		int   Range(void);
 		array Forward(int p, array& xp);
+		array ForwardPoints(array& X);
 		int   CompareChange(void);
 		array Reverse(int p, array& w);
 		array Jacobian(array& x);
 		array Hessian(array& x, array& w);
-		void  optimize(void);
+		boost::python::dict optimize(const std::string& options);
+		tuple ValueAndGrad(array& x);
+		tuple ValueJacHess(array& x, array& w);
+		array HessianVector(array& x, array& w, array& v);
+		array HessianDiagonal(array& x, array& w);
+		array JacVec(array& v);
+		array VecJac(array& u);
+		array Derivative(const std::string& kind, array& x_array);
+		int   TaylorId(void);
+		boost::python::dict Stats(void);
+		boost::python::dict Counters(void);
+		void  ResetCounters(void);
+		void  Profile(bool on);
+		boost::python::dict ProfileData(void);
+		boost::python::dict Memory(void);
+		void  CapacityOrder(int c);
+		void  CapacityPolicy(bool drop, int reserve);
 	};
 	typedef ADFun<double>    ADFun_double;
 	typedef ADFun<AD_double> ADFun_AD_double;
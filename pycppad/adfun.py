@@ -25,6 +25,9 @@
 # (i.e., a vector).
 # All the elements of $icode x$$ must all be of the same type and
 # instances of either $code int$$, $code float$$ or $code  a_float$$.
+# If they are not, a $code NotImplementedError$$ exception is raised.
+# The type checking and conversion are done in C++ 
+# (in one pass over the elements of $icode x$$).
 #
 # $head a_x$$ 
 # The return value $icode a_x$$ is a $code numpy.array$$ 
@@ -60,7 +63,9 @@
 # $index stop, recording$$
 #
 # $head Syntax$$
-# $icode%f% = adfun(%a_x%, %a_y%)%$$
+# $icode%f% = adfun(%a_x%, %a_y%)
+# %$$
+# $icode%f% = adfun(%a_x%, %a_y%, %optimize%)%$$
 #
 # $head Purpose$$
 # The function object $icode f$$ will store the $codei%type( %a_x%[0] )%$$
@@ -91,6 +96,13 @@
 # The length of the vector $icode a_y$$ determines the range size
 # $latex m$$ for the function $latex y = F(x)$$ below.
 #
+# $head optimize$$
+# If $icode optimize$$ is $code True$$, 
+# $icode%f%.optimize()%$$ is called before $icode f$$ is returned.
+# If it is a $code str$$, 
+# $icode%f%.optimize(%optimize%)%$$ is called; see $cref optimize$$.
+# The default value $code False$$ does not optimize $icode f$$.
+#
 # $head f$$
 # The return value $icode f$$ can be used to evaluate the function
 # $latex \[
@@ -144,6 +156,8 @@
 # If such a recording is currently in progress,
 # this will stop the recording and delete the corresponding information.
 # Otherwise, $code abort_recording$$ has no effect.
+# Only the recordings started by the current thread are aborted; 
+# see $cref recording_threads$$.
 #
 # $children%
 #	example/abort_recording.py
@@ -155,6 +169,275 @@
 #
 # $end
 # ---------------------------------------------------------------------------
+# $begin recording_threads$$ $newlinech #$$
+# $comment implemented in threads.cpp$$
+# $spell
+#	adfun
+#	threading
+#	CppAD
+# $$
+#
+# $section Record in More Than One Thread$$
+#
+# $index recording_threads$$
+# $index thread, recording$$
+# $index recording, thread$$
+# $index independent, thread$$
+#
+# $head Syntax$$
+# $codei%recording_threads(%n%)%$$
+#
+# $head Purpose$$
+# CppAD has one recording for each AD type ($code a_float$$ or 
+# $code a2float$$) and each thread number.
+# By default there is one thread number for the process, so only one
+# $code a_float$$ recording can be in progress at a time,
+# even when the calls to $cref independent$$ are in different 
+# python $code threading$$ threads.
+# This function allows up to $icode n$$ python threads 
+# to record at the same time.
+#
+# $head n$$
+# The argument $icode n$$ is a positive $code int$$.
+# The value one restores the default and 
+# $icode%n%+1%$$ must not be greater than the CppAD maximum number of threads
+# (which is 48 by default).
+# This function must not be called while a recording is in progress.
+#
+# $head Thread Numbers$$
+# A python thread that calls $cref independent$$ gets its own 
+# CppAD thread number and uses it while its recordings are in progress.
+# The recording stops when $cref adfun$$ is created or
+# $cref abort_recording$$ is called by the same thread.
+# The thread number is released when its recordings stop,
+# so another thread can use it for a new recording.
+# If $icode n$$ threads are already recording, 
+# $code independent$$ raises $code ValueError$$.
+# Operations using $code a_float$$ variables from a recording in 
+# another thread treat them as constants, and are not recorded.
+# The $cref/operation counts/profile/$$ and the current 
+# $cref/record_label/profile/$$ are kept for each thread number.
+#
+# $head Global Interpreter Lock$$
+# This does not make recording faster; there is no parallel speedup.
+# The operations are still done one at a time because 
+# pycppad never releases the python global interpreter lock.
+# The only change is that threads that record different functions 
+# at the same time do not need to wait for each other to finish 
+# their recording.
+# Finding the thread number adds a small cost to each operation
+# when $icode n$$ is greater than one.
+#
+# $children%
+#	example/recording_threads.py
+# %$$
+# $head Example$$
+# The file $cref/recording_threads.py/$$ 
+# contains an example and test of this operation.
+#
+# $end
+# ---------------------------------------------------------------------------
+# $begin linear_operator$$ $newlinech #$$
+# $spell
+#	numpy
+#	adfun
+#	scipy
+#	matvec
+#	rmatvec
+#	matmat
+#	rmatmat
+#	dtype
+#	Krylov
+# $$
+#
+# $section Matrix Free Jacobian Linear Operator$$
+#
+# $index linear_operator$$
+# $index jacobian, linear operator$$
+# $index matrix free, jacobian$$
+# $index Krylov, jacobian operator$$
+#
+# $head Syntax$$
+# $icode%A% = %f%.linear_operator(%x%)
+# %$$
+# $icode%jv% = %A%.matvec(%v%)
+# %$$
+# $icode%uj% = %A%.rmatvec(%u%)
+# %$$
+# $icode%JV% = %A%.matmat(%V%)
+# %$$
+# $icode%UJ% = %A%.rmatmat(%U%)%$$
+#
+# $head Purpose$$
+# Creates an object $icode A$$ that acts like the Jacobian
+# $latex F^{(1)} (x)$$ without forming it,
+# where $latex F : \B{R}^n \rightarrow \B{R}^m$$ is the function
+# corresponding to the $code adfun$$ object $cref/f/adfun/f/$$.
+# The object $icode A$$ has the attributes $code shape$$, $code dtype$$,
+# $code matvec$$, $code rmatvec$$, $code matmat$$ and $code rmatmat$$,
+# so it can be passed to $code scipy.sparse.linalg.aslinearoperator$$
+# and used by the $code scipy$$ Krylov solvers.
+#
+# $head f$$
+# The object $icode f$$ must be an $cref adfun$$ object.
+#
+# $head x$$
+# The argument $icode x$$ is a $code numpy.array$$ with one dimension
+# and length $cref/n/adfun/f/n/$$ that specifies the point at which the
+# Jacobian is evaluated; see $cref/x/jacobian/x/$$.
+# A copy of $icode x$$ is stored in $icode A$$.
+#
+# $head shape$$
+# The value $icode%A%.shape%$$ is the tuple $codei%(%m%, %n%)%$$.
+#
+# $head dtype$$
+# If the AD $cref/level/adfun/f/level/$$ for $icode f$$ is zero (one),
+# $icode%A%.dtype%$$ is $code float$$ ($code object$$).
+#
+# $head matvec$$
+# The argument $icode v$$ is a vector of length $icode n$$
+# and $icode jv$$ is the vector $latex F^{(1)} (x) v$$ of length $icode m$$.
+#
+# $head rmatvec$$
+# The argument $icode u$$ is a vector of length $icode m$$
+# and $icode uj$$ is the vector $latex F^{(1)} (x)^\R{T} u$$ 
+# of length $icode n$$.
+#
+# $head matmat$$
+# The argument $icode V$$ is a matrix with $icode n$$ rows and
+# $icode JV$$ is the matrix $latex F^{(1)} (x) V$$.
+#
+# $head rmatmat$$
+# The argument $icode U$$ is a matrix with $icode m$$ rows and
+# $icode UJ$$ is the matrix $latex F^{(1)} (x)^\R{T} U$$.
+#
+# $head Efficiency$$
+# The zero order Taylor coefficients for $icode f$$ at $icode x$$ are 
+# computed when $icode A$$ is created and reused by every product.
+# Each column in a product then costs one first order forward sweep
+# ($code matvec$$, $code matmat$$) or
+# one first order reverse sweep ($code rmatvec$$, $code rmatmat$$).
+# If some other use of $icode f$$ changes its zero order Taylor coefficients,
+# the next product recomputes them at $icode x$$.
+# The memory used is proportional to the size of the operation sequence
+# and not to $latex m \times n$$.
+#
+# $children%
+#	example/linear_operator.py
+# %$$
+# $head Example$$
+# The file $cref/linear_operator.py/$$ 
+# contains an example and test of this operation.
+#
+# $end
+# ---------------------------------------------------------------------------
+# $begin profile$$ $newlinech #$$
+# $spell
+#	numpy
+#	adfun
+#	dict
+#	bool
+#	condexp
+#	op
+#	flamegraph
+#	pl
+#	str
+# $$
+#
+# $section Operation Profiler$$
+#
+# $index profile$$
+# $index record_label$$
+# $index profile_report$$
+# $index profile_flamegraph$$
+# $index flame graph$$
+# $index hot, operations$$
+#
+# $head Syntax$$
+# $codei%record_label(%name%)
+# %$$
+# $icode%f%.profile(%on%)
+# %$$
+# $icode%report% = %f%.profile_report()
+# %$$
+# $icode%f%.profile_flamegraph(%file_name%)%$$
+#
+# $head Purpose$$
+# Measures the time spent in $cref forward$$ and $cref reverse$$
+# for an $cref adfun$$ object $icode f$$ and estimates
+# which recorded operations, and which parts of the
+# python code that did the recording, dominate that time.
+# Only the total time is measured; the time for each operation is an
+# estimate; see $cref/Estimate/profile/Estimate/$$.
+#
+# $head record_label$$
+# The argument $icode name$$ is a $code str$$.
+# Operations recorded after this call, and before the next call to
+# $code record_label$$ or $cref independent$$, are labeled by $icode name$$.
+# Operations recorded before the first call to $code record_label$$
+# have the empty label $code ''$$.
+#
+# $head on$$
+# The argument $icode on$$ is a $code bool$$.
+# If it is true, and profiling of $icode f$$ is not already on,
+# the profile times for $icode f$$ are set to zero and profiling is turned on.
+# If it is false, profiling is turned off 
+# (the times are kept for $code profile_report$$).
+# While profiling is on, the time for each call to 
+# $icode%f%.forward%$$ and $icode%f%.reverse%$$ is accumulated.
+#
+# $head report$$
+# The return value $icode report$$ is a list with one $code dict$$ for
+# each label and operation type that was recorded in $icode f$$.
+# It is sorted so the most expensive operations come first and
+# each element has the following keys:
+# $table
+# $bold key$$ $cnext $bold value$$ $rnext
+# $code label$$ $cnext the $code record_label$$ name $rnext
+# $code op$$    $cnext the operation name; see $cref/recorded_op/stats/recorded_op/$$ $rnext
+# $code count$$ $cnext number of times the operation was recorded with this label $rnext
+# $code estimated_fraction$$ $cnext 
+#	fraction of the sweep time estimated using the cost table $rnext
+# $code estimated_seconds$$ $cnext 
+#	$code estimated_fraction$$ times $code measured_seconds$$ $rnext
+# $code measured_seconds$$ $cnext 
+#	total measured $code forward$$ and $code reverse$$ seconds 
+#	(the same for every element)
+# $tend
+#
+# $head file_name$$
+# The argument $icode file_name$$ is a $code str$$ specifying the file
+# that $code profile_flamegraph$$ writes.
+# Each line has the folded stack format 
+# $codei%
+#	adfun_estimated;%label%;%op% %microseconds%
+# %$$
+# which is used by $code flamegraph.pl$$ and similar tools
+# (the $icode label$$ frame is left out for the empty label).
+# The value $icode microseconds$$ is $code estimated_seconds$$ in 
+# microseconds and the root frame name says that it is an estimate.
+# If no time has been profiled, the $code count$$ is used in place of
+# $icode microseconds$$ and the root frame is $code adfun_count$$.
+#
+# $head Estimate$$
+# CppAD does not time individual operations during a sweep.
+# The time profiled for $icode f$$ is divided among the recorded operations 
+# in proportion to their count times a fixed relative cost for their type;
+# e.g., $code exp$$ and $code pow$$ are more expensive than $code add$$.
+# The cost table is not measured on this machine.
+# Only operations recorded using the $code a_float$$ and $code a2float$$
+# operators and functions are included
+# and the counts are for the recording; i.e., before $cref optimize$$.
+#
+# $children%
+#	example/profile.py
+# %$$
+# $head Example$$
+# The file $cref/profile.py/$$ 
+# contains an example and test of this operation.
+#
+# $end
+# ---------------------------------------------------------------------------
 import cppad_
 import numpy
  
@@ -163,108 +446,141 @@ def independent(x) :
   a_x = independent(x): create independent variable vector a_x, equal to x,
   and start recording operations that use the class corresponding to ad( x[0] ).
   """
-  #
-  # It would be better faster if all this type checking were done in the C++
-  #
-  if not isinstance(x, numpy.ndarray) :
-    raise NotImplementedError('independent(x): x is not of type numpy.array')
-  #
-  x0 = x[0]
-  if isinstance(x0, int) :
-    for j in range( len(x) ) :
-      if not isinstance(x[j], int) :
-        other = 'x[' + str(j) + '] is ' + type(x[j]).__name__
-        msg   = 'independent(x): mixed types x[0] is int and ' + other
-        raise NotImplementedError(msg)
-    x = numpy.array(x, dtype=int)       # incase dtype of x is object
-    return cppad_.independent(x, 1)     # level = 1
-  #
-  if isinstance(x0, float) :
-    for j in range( len(x) ) :
-      if not isinstance(x[j], float) :
-        other = 'x[' + str(j) + '] is ' + type(x[j]).__name__
-        msg   = 'independent(x): mixed types x[0] is float and ' + other
-        raise NotImplementedError(msg)
-    x = numpy.array(x, dtype=float)     # incase dtype of x is object
-    return cppad_.independent(x, 1)     # level = 1
-  #
-  if isinstance(x0, cppad_.a_float) :
-    for j in range( len(x) ) :
-      if not isinstance(x[j], cppad_.a_float) :
-        other = 'x[' + str(j) + '] is ' + type(x[j]).__name__
-        msg   = 'independent(x): mixed types x[0] is a_float and ' + other
-        raise NotImplementedError(msg)
-    return cppad_.independent(x, 2)     # level = 2
-  #
-  msg = 'independent(x): x[0] has type' + type(x0).__name__ + '\n'
-  msg = 'only implemented where x[j] is int, float, or a_float'
-  raise NotImplementedError(msg)
+  return cppad_.independent(x)
+
+class linear_operator :
+  """
+  A = linear_operator(f, x): matrix free representation of the Jacobian
+  of f at x with the scipy LinearOperator attributes shape, dtype, matvec,
+  rmatvec, matmat and rmatmat.
+  """
+  def __init__(self, f, x, dtype) :
+    self.f     = f
+    self.x     = numpy.array(x)        # incase x changes after this call
+    self.shape = ( f.range(), f.domain() )
+    self.dtype = numpy.dtype(dtype)
+    self.pin_()
+  def pin_(self) :
+    self.f.forward(0, self.x)
+    self.taylor_id = self.f.taylor_id_()
+  def check_(self) :
+    if self.f.taylor_id_() != self.taylor_id :
+      self.pin_()
+  def matvec(self, v) :
+    self.check_()
+    return self.f.jac_vec_(v)
+  def rmatvec(self, u) :
+    self.check_()
+    return self.f.vec_jac_(u)
+  def matmat(self, V) :
+    self.check_()
+    return self.f.jac_vec_(V)
+  def rmatmat(self, U) :
+    self.check_()
+    return self.f.vec_jac_(U)
+
+def derivative_adfun_(f, kind, x) :
+  if kind == 'hessian_vector' :
+    x = numpy.concatenate( (x, x) )
+  if not kind in [ 'gradient', 'jacobian', 'hessian_vector' ] :
+    raise ValueError(
+      'derivative_adfun: kind is not gradient, jacobian, or hessian_vector'
+    )
+  if kind in [ 'gradient', 'hessian_vector' ] and f.range() != 1 :
+    raise ValueError('derivative_adfun: range of f is not one for ' + kind)
+  a_x = independent(x)
+  a_y = f.derivative_(kind, a_x)
+  g   = adfun(a_x, a_y, optimize = True)
+  # the operation recorded in g is owned by f
+  g.derivative_of_ = f
+  return g
+
+def profile_report_(f) :
+  data   = f.profile_data_()
+  cost   = data['cost']
+  total  = data['forward_seconds'] + data['reverse_seconds']
+  weight = 0.
+  for label in data['count'] :
+    for op, count in data['count'][label].items() :
+      weight += count * cost[op]
+  report = list()
+  for label in data['count'] :
+    for op, count in data['count'][label].items() :
+      fraction = count * cost[op] / weight
+      report.append( {
+        'label'              : label            ,
+        'op'                 : op               ,
+        'count'              : count            ,
+        'estimated_fraction' : fraction         ,
+        'estimated_seconds'  : fraction * total ,
+        'measured_seconds'   : total
+      } )
+  report.sort(key = lambda row : row['estimated_fraction'], reverse = True)
+  return report
+
+def profile_flamegraph_(f, file_name) :
+  report = profile_report_(f)
+  fp     = open(file_name, 'w')
+  for row in report :
+    if row['measured_seconds'] > 0. :
+      root  = 'adfun_estimated;'
+      value = int( round( row['estimated_seconds'] * 1e6 ) )
+    else :
+      root  = 'adfun_count;'
+      value = row['count']
+    if row['label'] == '' :
+      stack = root + row['op']
+    else :
+      stack = root + row['label'].replace(';', ',') + ';' + row['op']
+    fp.write( stack.replace(' ', '_') + ' ' + str(value) + '\n' )
+  fp.close()
 
 class adfun_float(cppad_.adfun_float) :
   """
   Create a level zero function object (evaluates using floats).
   """
-  # Kludge: The following reshaping should be done in adfun.cpp
-  def jacobian(self, x) :
-    return self.jacobian_(x).reshape(self.range(), self.domain())
-  def hessian(self, x, w) :
-    return self.hessian_(x, w).reshape(self.domain(), self.domain())
+  def linear_operator(self, x) :
+    return linear_operator(self, x, float)
+  def optimize(self, options = '') :
+    return self.optimize_(options)
+  def derivative_adfun(self, kind) :
+    return derivative_adfun_(self, kind, numpy.zeros( self.domain() ) )
+  def profile_report(self) :
+    return profile_report_(self)
+  def profile_flamegraph(self, file_name) :
+    profile_flamegraph_(self, file_name)
   pass
 
 class adfun_a_float(cppad_.adfun_a_float) :
   """
   Create a level one function object (evaluates using a_float).
   """
-  # Kludge: The following reshaping should be done in adfun.cpp
-  def jacobian(self, x) :
-    return self.jacobian_(x).reshape(self.range(), self.domain())
-  def hessian(self, x, w) :
-    return self.hessian_(x, w).reshape(self.domain(), self.domain())
+  def linear_operator(self, x) :
+    return linear_operator(self, x, object)
+  def optimize(self, options = '') :
+    return self.optimize_(options)
+  def derivative_adfun(self, kind) :
+    x = cppad_.ad_( numpy.zeros( self.domain() ) )
+    return derivative_adfun_(self, kind, x)
+  def profile_report(self) :
+    return profile_report_(self)
+  def profile_flamegraph(self, file_name) :
+    profile_flamegraph_(self, file_name)
   pass
 
-def adfun(x,y) :
+def adfun(x, y, optimize = False) :
   """
   f = adfun(x,y): Stop recording and place it in the function object f.
   x: a numpy one dimnesional array containing the independent variable vector.
   y: a vector with same type as x and containing the dependent variable vector.
+  optimize: if True (or an options string) f.optimize is called.
   """
-  #
-  # It would be better faster if all this type checking were done in the C++
-  #
-  if not isinstance(x, numpy.ndarray) or not isinstance(y, numpy.ndarray) :
-    raise NotImplementedError('adfun(x, y): x or y is not of type numpy.array')
-  #
-  x0 = x[0]
-  y0 = y[0]
-  if isinstance(x0, cppad_.a_float) :
-    for j in range( len(x) ) :
-      if not isinstance(x[j], cppad_.a_float) :
-        other = 'x[' + str(j) + '] is ' + type(x[j]).__name__
-        msg   = 'adfun(x, y): mixed types x[0] is a_float and ' + other
-        raise NotImplementedError(msg)
-    #
-    for i in range( len(y) ) :
-      if not isinstance(y[i], cppad_.a_float) :
-        other = 'y[' + str(i) + '] is ' + type(y[i]).__name__
-        msg   = 'adfun(x, y): mixed types x[0] is a_float and ' + other
-        raise NotImplementedError(msg)
-    #
-    return adfun_float(x, y)
-  #
-  if isinstance(x0, cppad_.a2float) :
-    for j in range( len(x) ) :
-      if not isinstance(x[j], cppad_.a2float) :
-        other = 'x[' + str(j) + '] is ' + type(x[j]).__name__
-        msg   = 'independent(x): mixed types x[0] is a2float and ' + other
-        raise NotImplementedError(msg)
-    #
-    for i in range( len(y) ) :
-      if not isinstance(y[i], cppad_.a2float) :
-        other = 'y[' + str(i) + '] is ' + type(y[i]).__name__
-        msg   = 'independent(x): mixed types x[0] is a2float and ' + other
-        raise NotImplementedError(msg)
-    #
-    return adfun_a_float(x, y)
-  #
-  raise NotImplementedError(
-        'adfun(x, y): elements of x and y are not a_float or a2float')
+  if cppad_.adfun_level_(x, y) == 1 :
+    f = adfun_float(x, y)
+  else :
+    f = adfun_a_float(x, y)
+  if optimize is True :
+    f.optimize()
+  elif optimize is not False :
+    f.optimize(optimize)
+  return f
@@ -0,0 +1,698 @@
+# include "atomic.hpp"
+# include <map>
+
+namespace pycppad {
+	namespace {
+		// name of an atomic function with the specified dimensions
+		std::string atomic_name(
+			const char* name, size_t n1, size_t n2, size_t n3)
+		{	std::stringstream s;
+			s << name << "_" << n1 << "_" << n2 << "_" << n3;
+			return s.str();
+		}
+		// a = a union b
+		void set_union(std::set<size_t>& a, const std::set<size_t>& b)
+		{	a.insert(b.begin(), b.end()); }
+	}
+	// =====================================================================
+	// atomic_matmul
+	template <class Base>
+	atomic_matmul<Base>::atomic_matmul(size_t m, size_t k, size_t n)
+	: CppAD::atomic_base<Base>( atomic_name("matmul", m, k, n) ),
+	m_(m), k_(k), n_(n)
+	{ }
+
+	// C_d = sum_{e=0}^d A_e * B_{d-e} for Taylor coefficient order d
+	template <class Base>
+	bool atomic_matmul<Base>::forward(
+		size_t p, size_t q, const bool_vector& vx,
+		bool_vector& vy, const base_vector& tx, base_vector& ty)
+	{	size_t nq = q + 1;
+		size_t nA = m_ * k_;
+		if( vx.size() > 0 )
+		{	for(size_t i = 0; i < m_; i++)
+			for(size_t j = 0; j < n_; j++)
+			{	bool var = false;
+				for(size_t l = 0; l < k_; l++)
+					var |= vx[i * k_ + l] | vx[nA + l * n_ + j];
+				vy[i * n_ + j] = var;
+			}
+		}
+		for(size_t i = 0; i < m_; i++)
+		for(size_t j = 0; j < n_; j++)
+		for(size_t d = p; d <= q; d++)
+		{	Base sum = Base(0.);
+			for(size_t l = 0; l < k_; l++)
+			{	const Base* a = &tx[ (i * k_ + l) * nq ];
+				const Base* b = &tx[ (nA + l * n_ + j) * nq ];
+				for(size_t e = 0; e <= d; e++)
+					sum += a[e] * b[d - e];
+			}
+			ty[ (i * n_ + j) * nq + d ] = sum;
+		}
+		return true;
+	}
+	template <class Base>
+	bool atomic_matmul<Base>::reverse(
+		size_t q, const base_vector& tx,
+		const base_vector& /* ty */, base_vector& px, const base_vector& py)
+	{	size_t nq = q + 1;
+		size_t nA = m_ * k_;
+		for(size_t i = 0; i < px.size(); i++)
+			px[i] = Base(0.);
+		for(size_t i = 0; i < m_; i++)
+		for(size_t j = 0; j < n_; j++)
+		for(size_t d = 0; d <= q; d++)
+		{	const Base& w = py[ (i * n_ + j) * nq + d ];
+			for(size_t l = 0; l < k_; l++)
+			{	size_t ia = (i * k_ + l) * nq;
+				size_t ib = (nA + l * n_ + j) * nq;
+				for(size_t e = 0; e <= d; e++)
+				{	px[ia + e]     += w * tx[ib + d - e];
+					px[ib + d - e] += w * tx[ia + e];
+				}
+			}
+		}
+		return true;
+	}
+	// C(i,j) depends on A(i,l) and B(l,j) for all l
+	template <class Base>
+	bool atomic_matmul<Base>::for_sparse_jac(
+		size_t /* q */, const set_vector& r, set_vector& s)
+	{	size_t nA = m_ * k_;
+		for(size_t i = 0; i < m_; i++)
+		for(size_t j = 0; j < n_; j++)
+		{	std::set<size_t>& sij = s[i * n_ + j];
+			sij.clear();
+			for(size_t l = 0; l < k_; l++)
+			{	set_union(sij, r[i * k_ + l]);
+				set_union(sij, r[nA + l * n_ + j]);
+			}
+		}
+		return true;
+	}
+	template <class Base>
+	bool atomic_matmul<Base>::rev_sparse_jac(
+		size_t /* q */, const set_vector& rt, set_vector& st)
+	{	size_t nA = m_ * k_;
+		for(size_t j = 0; j < st.size(); j++)
+			st[j].clear();
+		for(size_t i = 0; i < m_; i++)
+		for(size_t j = 0; j < n_; j++)
+		for(size_t l = 0; l < k_; l++)
+		{	set_union(st[i * k_ + l],      rt[i * n_ + j]);
+			set_union(st[nA + l * n_ + j], rt[i * n_ + j]);
+		}
+		return true;
+	}
+	// the only non-zero second partials are d^2 C(i,j) / dA(i,l) dB(l,j)
+	template <class Base>
+	bool atomic_matmul<Base>::rev_sparse_hes(
+		const bool_vector& /* vx */, const bool_vector& s, bool_vector& t,
+		size_t /* q */, const set_vector& r, const set_vector& u, set_vector& v)
+	{	size_t nA = m_ * k_;
+		for(size_t j = 0; j < t.size(); j++)
+		{	t[j] = false;
+			v[j].clear();
+		}
+		for(size_t i = 0; i < m_; i++)
+		for(size_t j = 0; j < n_; j++)
+		for(size_t l = 0; l < k_; l++)
+		{	size_t ic = i * n_ + j;
+			size_t ia = i * k_ + l;
+			size_t ib = nA + l * n_ + j;
+			set_union(v[ia], u[ic]);
+			set_union(v[ib], u[ic]);
+			if( s[ic] )
+			{	t[ia] = t[ib] = true;
+				set_union(v[ia], r[ib]);
+				set_union(v[ib], r[ia]);
+			}
+		}
+		return true;
+	}
+	// =====================================================================
+	// atomic_solve
+	template <class Base>
+	atomic_solve<Base>::atomic_solve(size_t n, size_t m, bool cholesky)
+	: CppAD::atomic_base<Base>(
+		atomic_name(cholesky ? "cholesky_solve" : "lu_solve", n, m, 0)
+	),
+	n_(n), m_(m), cholesky_(cholesky)
+	{ }
+
+	// index in A of element (i, j) of the matrix that A represents
+	template <class Base>
+	size_t atomic_solve<Base>::a_index(size_t i, size_t j) const
+	{	if( cholesky_ && i < j )
+			return j * n_ + i;
+		return i * n_ + j;
+	}
+
+	// LU: P * A = L * U with unit lower L and upper U stored in a,
+	// and row i of P * A is row perm[i] of A.
+	// Cholesky: A = L * L^T with L stored in the lower triangle of a.
+	template <class Base>
+	void atomic_solve<Base>::factor(
+		base_vector& a, CppAD::vector<size_t>& perm) const
+	{	size_t n = n_;
+		if( cholesky_ )
+		{	for(size_t j = 0; j < n; j++)
+			{	Base d = a[j * n + j];
+				for(size_t k = 0; k < j; k++)
+					d -= a[j * n + k] * a[j * n + k];
+				a[j * n + j] = CppAD::sqrt(d);
+				for(size_t i = j + 1; i < n; i++)
+				{	Base sum = a[i * n + j];
+					for(size_t k = 0; k < j; k++)
+						sum -= a[i * n + k] * a[j * n + k];
+					a[i * n + j] = sum / a[j * n + j];
+				}
+			}
+			return;
+		}
+		for(size_t i = 0; i < n; i++)
+			perm[i] = i;
+		for(size_t c = 0; c < n; c++)
+		{	// partial pivoting
+			size_t r = c;
+			for(size_t i = c + 1; i < n; i++)
+			{	if( CppAD::abs( a[i * n + c] ) > CppAD::abs( a[r * n + c] ) )
+					r = i;
+			}
+			if( r != c )
+			{	for(size_t j = 0; j < n; j++)
+					std::swap( a[r * n + j], a[c * n + j] );
+				std::swap( perm[r], perm[c] );
+			}
+			for(size_t i = c + 1; i < n; i++)
+			{	a[i * n + c] /= a[c * n + c];
+				for(size_t j = c + 1; j < n; j++)
+					a[i * n + j] -= a[i * n + c] * a[c * n + j];
+			}
+		}
+	}
+	// Replace the n by m matrix z by A^{-1} * z (A^{-T} * z if transpose)
+	template <class Base>
+	void atomic_solve<Base>::solve(
+		const base_vector& a, const CppAD::vector<size_t>& perm,
+		bool transpose, base_vector& z) const
+	{	size_t n = n_;
+		size_t m = m_;
+		if( cholesky_ )
+		{	// L * L^T is symmetric so transpose does not matter
+			for(size_t j = 0; j < m; j++)
+			{	for(size_t i = 0; i < n; i++)
+				{	for(size_t k = 0; k < i; k++)
+						z[i * m + j] -= a[i * n + k] * z[k * m + j];
+					z[i * m + j] /= a[i * n + i];
+				}
+				for(size_t i = n; i-- > 0; )
+				{	for(size_t k = i + 1; k < n; k++)
+						z[i * m + j] -= a[k * n + i] * z[k * m + j];
+					z[i * m + j] /= a[i * n + i];
+				}
+			}
+			return;
+		}
+		base_vector w(n);
+		for(size_t j = 0; j < m; j++)
+		{	if( ! transpose )
+			{	// L * U * z = P * z
+				for(size_t i = 0; i < n; i++)
+				{	w[i] = z[ perm[i] * m + j ];
+					for(size_t k = 0; k < i; k++)
+						w[i] -= a[i * n + k] * w[k];
+				}
+				for(size_t i = n; i-- > 0; )
+				{	for(size_t k = i + 1; k < n; k++)
+						w[i] -= a[i * n + k] * w[k];
+					w[i] /= a[i * n + i];
+				}
+				for(size_t i = 0; i < n; i++)
+					z[i * m + j] = w[i];
+			}
+			else
+			{	// U^T * L^T * P * z = z
+				for(size_t i = 0; i < n; i++)
+				{	w[i] = z[i * m + j];
+					for(size_t k = 0; k < i; k++)
+						w[i] -= a[k * n + i] * w[k];
+					w[i] /= a[i * n + i];
+				}
+				for(size_t i = n; i-- > 0; )
+				{	for(size_t k = i + 1; k < n; k++)
+						w[i] -= a[k * n + i] * w[k];
+				}
+				for(size_t i = 0; i < n; i++)
+					z[ perm[i] * m + j ] = w[i];
+			}
+		}
+	}
+	// A_0 * Y_d = B_d - sum_{e=1}^d A_e * Y_{d-e}
+	template <class Base>
+	bool atomic_solve<Base>::forward(
+		size_t p, size_t q, const bool_vector& vx,
+		bool_vector& vy, const base_vector& tx, base_vector& ty)
+	{	size_t n  = n_;
+		size_t m  = m_;
+		size_t nq = q + 1;
+		size_t nA = n * n;
+		if( vx.size() > 0 )
+		{	bool var_a = false;
+			for(size_t i = 0; i < nA; i++)
+				var_a |= vx[i];
+			for(size_t j = 0; j < m; j++)
+			{	bool var = var_a;
+				for(size_t i = 0; i < n; i++)
+					var |= vx[nA + i * m + j];
+				for(size_t i = 0; i < n; i++)
+					vy[i * m + j] = var;
+			}
+		}
+		base_vector a(nA), z(n * m);
+		CppAD::vector<size_t> perm(n);
+		for(size_t i = 0; i < n; i++)
+		for(size_t j = 0; j < n; j++)
+			a[i * n + j] = tx[ a_index(i, j) * nq ];
+		factor(a, perm);
+		for(size_t d = p; d <= q; d++)
+		{	for(size_t i = 0; i < n; i++)
+			for(size_t j = 0; j < m; j++)
+			{	Base sum = tx[ (nA + i * m + j) * nq + d ];
+				for(size_t e = 1; e <= d; e++)
+				for(size_t k = 0; k < n; k++)
+					sum -= tx[ a_index(i, k) * nq + e ]
+					     * ty[ (k * m + j) * nq + d - e ];
+				z[i * m + j] = sum;
+			}
+			solve(a, perm, false, z);
+			for(size_t i = 0; i < n * m; i++)
+				ty[i * nq + d] = z[i];
+		}
+		return true;
+	}
+	// reverse of the forward recursion above for d = q, ..., 0
+	template <class Base>
+	bool atomic_solve<Base>::reverse(
+		size_t q, const base_vector& tx,
+		const base_vector& ty, base_vector& px, const base_vector& py)
+	{	size_t n  = n_;
+		size_t m  = m_;
+		size_t nq = q + 1;
+		size_t nA = n * n;
+		base_vector a(nA), w(n * m), pyy(py);
+		CppAD::vector<size_t> perm(n);
+		for(size_t i = 0; i < n; i++)
+		for(size_t j = 0; j < n; j++)
+			a[i * n + j] = tx[ a_index(i, j) * nq ];
+		factor(a, perm);
+		for(size_t i = 0; i < px.size(); i++)
+			px[i] = Base(0.);
+		for(size_t d = q + 1; d-- > 0; )
+		{	// w = A_0^{-T} * partial of Y_d
+			for(size_t i = 0; i < n * m; i++)
+				w[i] = pyy[i * nq + d];
+			solve(a, perm, true, w);
+			for(size_t i = 0; i < n * m; i++)
+				px[ (nA + i) * nq + d ] += w[i];
+			for(size_t e = 0; e <= d; e++)
+			{	// partial of A_e -= w * Y_{d-e}^T
+				for(size_t i = 0; i < n; i++)
+				for(size_t k = 0; k < n; k++)
+				{	Base sum = Base(0.);
+					for(size_t j = 0; j < m; j++)
+						sum += w[i * m + j] * ty[ (k * m + j) * nq + d - e ];
+					px[ a_index(i, k) * nq + e ] -= sum;
+				}
+				if( e == 0 )
+					continue;
+				// partial of Y_{d-e} -= A_e^T * w
+				for(size_t k = 0; k < n; k++)
+				for(size_t j = 0; j < m; j++)
+				{	Base sum = Base(0.);
+					for(size_t i = 0; i < n; i++)
+						sum += tx[ a_index(i, k) * nq + e ] * w[i * m + j];
+					pyy[ (k * m + j) * nq + d - e ] -= sum;
+				}
+			}
+		}
+		return true;
+	}
+	// Y(i,j) depends on all of A and on column j of B
+	template <class Base>
+	bool atomic_solve<Base>::for_sparse_jac(
+		size_t /* q */, const set_vector& r, set_vector& s)
+	{	size_t nA = n_ * n_;
+		std::set<size_t> ra;
+		for(size_t i = 0; i < nA; i++)
+			set_union(ra, r[i]);
+		for(size_t j = 0; j < m_; j++)
+		{	std::set<size_t> sj = ra;
+			for(size_t i = 0; i < n_; i++)
+				set_union(sj, r[nA + i * m_ + j]);
+			for(size_t i = 0; i < n_; i++)
+				s[i * m_ + j] = sj;
+		}
+		return true;
+	}
+	template <class Base>
+	bool atomic_solve<Base>::rev_sparse_jac(
+		size_t /* q */, const set_vector& rt, set_vector& st)
+	{	size_t nA = n_ * n_;
+		std::set<size_t> all;
+		for(size_t j = 0; j < m_; j++)
+		{	std::set<size_t> sj;
+			for(size_t i = 0; i < n_; i++)
+				set_union(sj, rt[i * m_ + j]);
+			for(size_t i = 0; i < n_; i++)
+				st[nA + i * m_ + j] = sj;
+			set_union(all, sj);
+		}
+		for(size_t i = 0; i < nA; i++)
+			st[i] = all;
+		return true;
+	}
+	// Y is linear in B and non-linear in A (conservative pattern)
+	template <class Base>
+	bool atomic_solve<Base>::rev_sparse_hes(
+		const bool_vector& /* vx */, const bool_vector& s, bool_vector& t,
+		size_t /* q */, const set_vector& r, const set_vector& u, set_vector& v)
+	{	size_t nA = n_ * n_;
+		std::set<size_t> ra, rb, u_all;
+		bool s_any = false;
+		for(size_t i = 0; i < nA; i++)
+			set_union(ra, r[i]);
+		for(size_t j = 0; j < m_; j++)
+		{	bool s_j = false;
+			std::set<size_t> u_j;
+			for(size_t i = 0; i < n_; i++)
+			{	s_j |= s[i * m_ + j];
+				set_union(u_j, u[i * m_ + j]);
+			}
+			for(size_t i = 0; i < n_; i++)
+			{	size_t ib = nA + i * m_ + j;
+				t[ib] = s_j;
+				v[ib] = u_j;
+				if( s_j )
+				{	set_union(v[ib], ra);
+					set_union(rb, r[ib]);
+				}
+			}
+			s_any |= s_j;
+			set_union(u_all, u_j);
+		}
+		for(size_t i = 0; i < nA; i++)
+		{	t[i] = s_any;
+			v[i] = u_all;
+			if( s_any )
+			{	set_union(v[i], ra);
+				set_union(v[i], rb);
+			}
+		}
+		return true;
+	}
+	// =====================================================================
+	// atomic_sum
+	template <class Base>
+	atomic_sum<Base>::atomic_sum(size_t n, bool square)
+	: CppAD::atomic_base<Base>(
+		atomic_name(square ? "sumsq" : "sum", n, 0, 0)
+	),
+	n_(n), square_(square)
+	{ }
+
+	// y_d = sum_i x_{i,d}  or  y_d = sum_i sum_{e=0}^d x_{i,e} * x_{i,d-e}
+	template <class Base>
+	bool atomic_sum<Base>::forward(
+		size_t p, size_t q, const bool_vector& vx,
+		bool_vector& vy, const base_vector& tx, base_vector& ty)
+	{	size_t nq = q + 1;
+		if( vx.size() > 0 )
+		{	bool var = false;
+			for(size_t i = 0; i < n_; i++)
+				var |= vx[i];
+			vy[0] = var;
+		}
+		for(size_t d = p; d <= q; d++)
+		{	Base sum = Base(0.);
+			for(size_t i = 0; i < n_; i++)
+			{	const Base* x = &tx[i * nq];
+				if( ! square_ )
+					sum += x[d];
+				else for(size_t e = 0; e <= d; e++)
+					sum += x[e] * x[d - e];
+			}
+			ty[d] = sum;
+		}
+		return true;
+	}
+	template <class Base>
+	bool atomic_sum<Base>::reverse(
+		size_t q, const base_vector& tx,
+		const base_vector& /* ty */, base_vector& px, const base_vector& py)
+	{	size_t nq = q + 1;
+		for(size_t i = 0; i < n_; i++)
+		for(size_t d = 0; d <= q; d++)
+		{	if( ! square_ )
+				px[i * nq + d] = py[d];
+			else
+			{	px[i * nq + d] = Base(0.);
+				for(size_t e = d; e <= q; e++)
+					px[i * nq + d] += Base(2.) * py[e] * tx[i * nq + e - d];
+			}
+		}
+		return true;
+	}
+	template <class Base>
+	bool atomic_sum<Base>::for_sparse_jac(
+		size_t /* q */, const set_vector& r, set_vector& s)
+	{	s[0].clear();
+		for(size_t i = 0; i < n_; i++)
+			set_union(s[0], r[i]);
+		return true;
+	}
+	template <class Base>
+	bool atomic_sum<Base>::rev_sparse_jac(
+		size_t /* q */, const set_vector& rt, set_vector& st)
+	{	for(size_t i = 0; i < n_; i++)
+			st[i] = rt[0];
+		return true;
+	}
+	// the only non-zero second partials are d^2 y / dx_i dx_i for square
+	template <class Base>
+	bool atomic_sum<Base>::rev_sparse_hes(
+		const bool_vector& /* vx */, const bool_vector& s, bool_vector& t,
+		size_t /* q */, const set_vector& r, const set_vector& u, set_vector& v)
+	{	for(size_t i = 0; i < n_; i++)
+		{	t[i] = s[0];
+			v[i] = u[0];
+			if( square_ && s[0] )
+				set_union(v[i], r[i]);
+		}
+		return true;
+	}
+	// =====================================================================
+	// atomic_derivative
+	namespace {
+		const char* derivative_name[] = {
+			"gradient", "jacobian", "hessian_vector"
+		};
+		// a derivative order that atomic_derivative does not support
+		void derivative_order_error(
+			derivative_kind kind, const char* mode, size_t q)
+		{	std::stringstream msg;
+			msg << "derivative_adfun: " << derivative_name[kind]
+			    << " does not support order " << q << " " << mode
+			    << "; only zero order forward is supported";
+			if( kind == derivative_gradient )
+				msg << " and first order forward and reverse";
+			throw not_implemented( msg.str().c_str() );
+		}
+	}
+	template <class Base>
+	atomic_derivative<Base>::atomic_derivative(
+		CppAD::ADFun<Base>& f, derivative_kind kind)
+	: CppAD::atomic_base<Base>(
+		atomic_name(derivative_name[kind], f.Domain(), f.Range(), 0)
+	),
+	kind_(kind), n_( f.Domain() )
+	{	f_ = f; }
+
+	// uses forward mode in direction v followed by second order reverse
+	template <class Base>
+	void atomic_derivative<Base>::hessian_vector(
+		const base_vector& x, const base_vector& v,
+		base_vector& hv, base_vector* gradient)
+	{	base_vector w(1), dw(2 * n_);
+		w[0] = Base(1.);
+		f_.Forward(0, x);
+		f_.Forward(1, v);
+		dw = f_.Reverse(2, w);
+		for(size_t j = 0; j < n_; j++)
+		{	hv[j] = dw[j * 2 + 1];
+			if( gradient != 0 )
+				(*gradient)[j] = dw[j * 2];
+		}
+	}
+
+	// zero order for every kind, first order for derivative_gradient
+	// where the first order coefficient of y is f''(x_0) * x_1
+	template <class Base>
+	bool atomic_derivative<Base>::forward(
+		size_t /* p */, size_t q, const bool_vector& vx,
+		bool_vector& vy, const base_vector& tx, base_vector& ty)
+	{	size_t nq = q + 1;
+		size_t ny = ty.size() / nq;
+		if( vx.size() > 0 )
+		{	bool var = false;
+			for(size_t j = 0; j < vx.size(); j++)
+				var |= vx[j];
+			for(size_t i = 0; i < ny; i++)
+				vy[i] = var;
+		}
+		if( q > 1 || (q == 1 && kind_ != derivative_gradient) )
+			derivative_order_error(kind_, "forward", q);
+		base_vector x(n_), y(ny);
+		for(size_t j = 0; j < n_; j++)
+			x[j] = tx[j * nq];
+		if( kind_ == derivative_gradient )
+		{	base_vector w(1);
+			w[0] = Base(1.);
+			if( q == 0 )
+			{	f_.Forward(0, x);
+				y = f_.Reverse(1, w);
+			}
+			else
+			{	base_vector dx(n_), hv(n_);
+				for(size_t j = 0; j < n_; j++)
+					dx[j] = tx[j * nq + 1];
+				hessian_vector(x, dx, hv, &y);
+				for(size_t j = 0; j < n_; j++)
+					ty[j * nq + 1] = hv[j];
+			}
+		}
+		else if( kind_ == derivative_jacobian )
+			y = f_.Jacobian(x);
+		else
+		{	base_vector v(n_);
+			for(size_t j = 0; j < n_; j++)
+				v[j] = tx[(n_ + j) * nq];
+			hessian_vector(x, v, y, 0);
+		}
+		for(size_t i = 0; i < ny; i++)
+			ty[i * nq] = y[i];
+		return true;
+	}
+	// first order for derivative_gradient where px = f''(x_0) * py
+	// (the Hessian is symmetric)
+	template <class Base>
+	bool atomic_derivative<Base>::reverse(
+		size_t q, const base_vector& tx,
+		const base_vector& /* ty */, base_vector& px, const base_vector& py)
+	{	if( q > 0 || kind_ != derivative_gradient )
+			derivative_order_error(kind_, "reverse", q + 1);
+		base_vector x(n_), hv(n_);
+		for(size_t j = 0; j < n_; j++)
+			x[j] = tx[j];
+		hessian_vector(x, py, hv, 0);
+		for(size_t j = 0; j < n_; j++)
+			px[j] = hv[j];
+		return true;
+	}
+	// every component of y may depend on every component of x
+	template <class Base>
+	bool atomic_derivative<Base>::for_sparse_jac(
+		size_t /* q */, const set_vector& r, set_vector& s)
+	{	std::set<size_t> r_all;
+		for(size_t j = 0; j < r.size(); j++)
+			set_union(r_all, r[j]);
+		for(size_t i = 0; i < s.size(); i++)
+			s[i] = r_all;
+		return true;
+	}
+	template <class Base>
+	bool atomic_derivative<Base>::rev_sparse_jac(
+		size_t /* q */, const set_vector& rt, set_vector& st)
+	{	std::set<size_t> rt_all;
+		for(size_t i = 0; i < rt.size(); i++)
+			set_union(rt_all, rt[i]);
+		for(size_t j = 0; j < st.size(); j++)
+			st[j] = rt_all;
+		return true;
+	}
+	template <class Base>
+	bool atomic_derivative<Base>::rev_sparse_hes(
+		const bool_vector& /* vx */, const bool_vector& s, bool_vector& t,
+		size_t /* q */, const set_vector& r, const set_vector& u, set_vector& v)
+	{	bool s_any = false;
+		std::set<size_t> u_all, r_all;
+		for(size_t i = 0; i < s.size(); i++)
+		{	s_any |= s[i];
+			set_union(u_all, u[i]);
+		}
+		for(size_t j = 0; j < r.size(); j++)
+			set_union(r_all, r[j]);
+		for(size_t j = 0; j < t.size(); j++)
+		{	t[j] = s_any;
+			v[j] = u_all;
+			if( s_any )
+				set_union(v[j], r_all);
+		}
+		return true;
+	}
+	// =====================================================================
+	template <class Base>
+	atomic_matmul<Base>& matmul_atomic(size_t m, size_t k, size_t n)
+	{	typedef std::map< std::string, atomic_matmul<Base>* > map;
+		static map atomic;
+		std::string name = atomic_name("matmul", m, k, n);
+		typename map::iterator itr = atomic.find(name);
+		if( itr != atomic.end() )
+			return *(itr->second);
+		atomic_matmul<Base>* afun = new atomic_matmul<Base>(m, k, n);
+		atomic[name] = afun;
+		return *afun;
+	}
+	template <class Base>
+	atomic_solve<Base>& solve_atomic(size_t n, size_t m, bool cholesky)
+	{	typedef std::map< std::string, atomic_solve<Base>* > map;
+		static map atomic;
+		std::string name = atomic_name(
+			cholesky ? "cholesky_solve" : "lu_solve", n, m, 0
+		);
+		typename map::iterator itr = atomic.find(name);
+		if( itr != atomic.end() )
+			return *(itr->second);
+		atomic_solve<Base>* afun = new atomic_solve<Base>(n, m, cholesky);
+		atomic[name] = afun;
+		return *afun;
+	}
+	template <class Base>
+	atomic_sum<Base>& sum_atomic(size_t n, bool square)
+	{	typedef std::map< std::string, atomic_sum<Base>* > map;
+		static map atomic;
+		std::string name = atomic_name(square ? "sumsq" : "sum", n, 0, 0);
+		typename map::iterator itr = atomic.find(name);
+		if( itr != atomic.end() )
+			return *(itr->second);
+		atomic_sum<Base>* afun = new atomic_sum<Base>(n, square);
+		atomic[name] = afun;
+		return *afun;
+	}
+	// =====================================================================
+	template class atomic_matmul<double>;
+	template class atomic_matmul<AD_double>;
+	template class atomic_solve<double>;
+	template class atomic_solve<AD_double>;
+	template atomic_matmul<double>&    matmul_atomic(size_t, size_t, size_t);
+	template atomic_matmul<AD_double>& matmul_atomic(size_t, size_t, size_t);
+	template atomic_solve<double>&     solve_atomic(size_t, size_t, bool);
+	template atomic_solve<AD_double>&  solve_atomic(size_t, size_t, bool);
+	template class atomic_sum<double>;
+	template class atomic_sum<AD_double>;
+	template atomic_sum<double>&       sum_atomic(size_t, bool);
+	template atomic_sum<AD_double>&    sum_atomic(size_t, bool);
+	template class atomic_derivative<double>;
+	template class atomic_derivative<AD_double>;
+}
@@ -0,0 +1,146 @@
+# ifndef PYCPPAD_ATOMIC_INCLUDED
+# define PYCPPAD_ATOMIC_INCLUDED
+
+# include "environment.hpp"
+
+/*
+Dense linear algebra operations that are recorded as one CppAD atomic
+operation (instead of one operation for every scalar multiply and add).
+Matrices are stored in row major order and the argument vector of each
+atomic function is its matrix operands one after the other.
+*/
+namespace pycppad {
+	// C = A * B where A is m by k, B is k by n, and C is m by n
+	template <class Base>
+	class atomic_matmul : public CppAD::atomic_base<Base> {
+	private:
+		const size_t m_, k_, n_;
+	public:
+		atomic_matmul(size_t m, size_t k, size_t n);
+	private:
+		typedef CppAD::vector<bool>                  bool_vector;
+		typedef CppAD::vector<Base>                  base_vector;
+		typedef CppAD::vector< std::set<size_t> >    set_vector;
+		virtual bool forward(size_t p, size_t q, const bool_vector& vx,
+			bool_vector& vy, const base_vector& tx, base_vector& ty);
+		virtual bool reverse(size_t q, const base_vector& tx,
+			const base_vector& ty, base_vector& px, const base_vector& py);
+		virtual bool for_sparse_jac(
+			size_t q, const set_vector& r, set_vector& s);
+		virtual bool rev_sparse_jac(
+			size_t q, const set_vector& rt, set_vector& st);
+		virtual bool rev_sparse_hes(const bool_vector& vx,
+			const bool_vector& s, bool_vector& t, size_t q,
+			const set_vector& r, const set_vector& u, set_vector& v);
+	};
+
+	// Y = A^{-1} * B where A is n by n, B is n by m, and Y is n by m.
+	// If cholesky is true, A is symmetric positive definite and only its
+	// lower triangle is used; otherwise an LU factorization is used.
+	template <class Base>
+	class atomic_solve : public CppAD::atomic_base<Base> {
+	private:
+		const size_t n_, m_;
+		const bool   cholesky_;
+	public:
+		atomic_solve(size_t n, size_t m, bool cholesky);
+	private:
+		typedef CppAD::vector<bool>                  bool_vector;
+		typedef CppAD::vector<Base>                  base_vector;
+		typedef CppAD::vector< std::set<size_t> >    set_vector;
+		// element (i, j) of the matrix that A represents
+		size_t a_index(size_t i, size_t j) const;
+		// factor A, solve A * Z = Z, or solve A^T * Z = Z
+		void factor(base_vector& a, CppAD::vector<size_t>& perm) const;
+		void solve(const base_vector& a, const CppAD::vector<size_t>& perm,
+			bool transpose, base_vector& z) const;
+		virtual bool forward(size_t p, size_t q, const bool_vector& vx,
+			bool_vector& vy, const base_vector& tx, base_vector& ty);
+		virtual bool reverse(size_t q, const base_vector& tx,
+			const base_vector& ty, base_vector& px, const base_vector& py);
+		virtual bool for_sparse_jac(
+			size_t q, const set_vector& r, set_vector& s);
+		virtual bool rev_sparse_jac(
+			size_t q, const set_vector& rt, set_vector& st);
+		virtual bool rev_sparse_hes(const bool_vector& vx,
+			const bool_vector& s, bool_vector& t, size_t q,
+			const set_vector& r, const set_vector& u, set_vector& v);
+	};
+
+	// y = x_0 + ... + x_{n-1} (or x_0^2 + ... + x_{n-1}^2 if square)
+	template <class Base>
+	class atomic_sum : public CppAD::atomic_base<Base> {
+	private:
+		const size_t n_;
+		const bool   square_;
+	public:
+		atomic_sum(size_t n, bool square);
+	private:
+		typedef CppAD::vector<bool>                  bool_vector;
+		typedef CppAD::vector<Base>                  base_vector;
+		typedef CppAD::vector< std::set<size_t> >    set_vector;
+		virtual bool forward(size_t p, size_t q, const bool_vector& vx,
+			bool_vector& vy, const base_vector& tx, base_vector& ty);
+		virtual bool reverse(size_t q, const base_vector& tx,
+			const base_vector& ty, base_vector& px, const base_vector& py);
+		virtual bool for_sparse_jac(
+			size_t q, const set_vector& r, set_vector& s);
+		virtual bool rev_sparse_jac(
+			size_t q, const set_vector& rt, set_vector& st);
+		virtual bool rev_sparse_hes(const bool_vector& vx,
+			const bool_vector& s, bool_vector& t, size_t q,
+			const set_vector& r, const set_vector& u, set_vector& v);
+	};
+
+	// Derivative of the function f as one atomic operation:
+	// derivative_gradient       y = f'(x)^T              (f has range one)
+	// derivative_jacobian       y = f'(x) in row major order
+	// derivative_hessian_vector y = f''(x) * v, x and v are the argument
+	//                           one after the other    (f has range one)
+	// Derivatives of y are only supported for derivative_gradient.
+	enum derivative_kind {
+		derivative_gradient,
+		derivative_jacobian,
+		derivative_hessian_vector
+	};
+	template <class Base>
+	class atomic_derivative : public CppAD::atomic_base<Base> {
+	private:
+		// a copy of f so evaluating y does not change the Taylor
+		// coefficients stored in the original
+		CppAD::ADFun<Base>    f_;
+		const derivative_kind kind_;
+		const size_t          n_;
+	public:
+		atomic_derivative(CppAD::ADFun<Base>& f, derivative_kind kind);
+	private:
+		typedef CppAD::vector<bool>                  bool_vector;
+		typedef CppAD::vector<Base>                  base_vector;
+		typedef CppAD::vector< std::set<size_t> >    set_vector;
+		// f''(x) * v (and f'(x)^T in gradient if it is not null)
+		void hessian_vector(const base_vector& x, const base_vector& v,
+			base_vector& hv, base_vector* gradient);
+		virtual bool forward(size_t p, size_t q, const bool_vector& vx,
+			bool_vector& vy, const base_vector& tx, base_vector& ty);
+		virtual bool reverse(size_t q, const base_vector& tx,
+			const base_vector& ty, base_vector& px, const base_vector& py);
+		virtual bool for_sparse_jac(
+			size_t q, const set_vector& r, set_vector& s);
+		virtual bool rev_sparse_jac(
+			size_t q, const set_vector& rt, set_vector& st);
+		virtual bool rev_sparse_hes(const bool_vector& vx,
+			const bool_vector& s, bool_vector& t, size_t q,
+			const set_vector& r, const set_vector& u, set_vector& v);
+	};
+
+	// The atomic function for each dimension is created the first time
+	// it is used and is never deleted (operation sequences refer to it).
+	template <class Base>
+	atomic_matmul<Base>& matmul_atomic(size_t m, size_t k, size_t n);
+	template <class Base>
+	atomic_solve<Base>& solve_atomic(size_t n, size_t m, bool cholesky);
+	template <class Base>
+	atomic_sum<Base>& sum_atomic(size_t n, bool square);
+}
+
+# endif
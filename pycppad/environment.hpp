@@ -12,6 +12,8 @@
 # include <string>
 # include <cassert>
 # include <exception>
+# include <set>
+# include <sstream>
 
 # define PYCPPAD_ASSERT(expression, message) \
 { 	if( ! ( expression ) )                    \
@@ -33,6 +35,8 @@ namespace pycppad {
 	using boost::python::object;
 	using boost::python::numeric::array;
 	using boost::python::extract;
+	using boost::python::tuple;
+	using boost::python::make_tuple;
 
 	class exception : public std::exception
 	{	
@@ -46,6 +50,13 @@ namespace pycppad {
 		const char* what(void) const throw()
 		{	return message_; }
 	};
+	// exception that is translated to a python NotImplementedError
+	class not_implemented : public exception
+	{
+	public :
+		not_implemented(const char* message) : exception(message)
+		{ }
+	};
 }
 
 # endif
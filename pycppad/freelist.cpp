@@ -0,0 +1,121 @@
+# include "freelist.hpp"
+# include <cstring>
+
+# ifndef Py_SET_SIZE
+# define Py_SET_SIZE(obj, size) ((Py_SIZE(obj) = (size)), (void)0)
+# endif
+
+namespace pycppad {
+	namespace {
+		// maximum number of blocks held on one freelist
+		const size_t max_block_ = 4096;
+
+		struct freelist {
+			PyTypeObject* type;    // python class for this freelist
+			allocfunc     alloc;   // tp_alloc before install_freelist
+			freefunc      free;    // tp_free before install_freelist
+			Py_ssize_t    nitems;  // every block has room for nitems
+			size_t        n_block; // number of blocks on the freelist
+			void*         block[max_block_];
+		};
+
+		// one freelist for a_float and one for a2float
+		const size_t max_list_ = 2;
+		freelist list_[max_list_];
+		size_t   n_list_ = 0;
+
+		freelist* find(PyTypeObject* type)
+		{	for(size_t i = 0; i < n_list_; i++)
+			{	if( list_[i].type == type )
+					return list_ + i;
+			}
+			return 0;
+		}
+		size_t block_bytes(const freelist& list)
+		{	return static_cast<size_t>(
+				_PyObject_VAR_SIZE(list.type, list.nitems + 1)
+			);
+		}
+
+		// The python C API calls these with the global interpreter lock
+		// held, so the freelists do not need a lock of their own.
+		PyObject* freelist_alloc(PyTypeObject* type, Py_ssize_t nitems)
+		{	freelist* list = find(type);
+			if( list == 0 )
+				return PyType_GenericAlloc(type, nitems);
+			if( list->n_block == 0 || nitems > list->nitems )
+			{	// new blocks are large enough to be reused for any
+				// request that the freelist serves
+				Py_ssize_t n = nitems < list->nitems ? list->nitems : nitems;
+				PyObject* obj = list->alloc(type, n);
+				if( obj != 0 && type->tp_itemsize != 0 )
+					Py_SET_SIZE(obj, nitems);
+				return obj;
+			}
+			// same steps as PyType_GenericAlloc using a recycled block
+			PyObject* obj = static_cast<PyObject*>(
+				list->block[ --list->n_block ]
+			);
+			std::memset(obj, 0, _PyObject_VAR_SIZE(type, nitems + 1) );
+# if PY_VERSION_HEX < 0x03080000
+			if( type->tp_flags & Py_TPFLAGS_HEAPTYPE )
+				Py_INCREF(type);
+# endif
+			if( type->tp_itemsize == 0 )
+				PyObject_INIT(obj, type);
+			else	PyObject_INIT_VAR(
+					reinterpret_cast<PyVarObject*>(obj), type, nitems
+				);
+			if( PyType_IS_GC(type) )
+				PyObject_GC_Track(obj);
+			return obj;
+		}
+		void freelist_free(void* ptr)
+		{	PyObject* obj  = static_cast<PyObject*>(ptr);
+			freelist* list = find( Py_TYPE(obj) );
+			if( list == 0 )
+			{	if( PyType_IS_GC( Py_TYPE(obj) ) )
+					PyObject_GC_Del(ptr);
+				else	PyObject_Del(ptr);
+				return;
+			}
+			if( list->n_block == max_block_ )
+			{	list->free(ptr);
+				return;
+			}
+			if( PyType_IS_GC( list->type ) )
+				PyObject_GC_UnTrack(ptr);
+			list->block[ list->n_block++ ] = ptr;
+		}
+	}
+
+	void install_freelist(PyTypeObject* type, Py_ssize_t nitems)
+	{	PYCPPAD_ASSERT( n_list_ < max_list_ , "");
+		PYCPPAD_ASSERT( find(type) == 0 , "");
+		freelist& list = list_[n_list_++];
+		list.type      = type;
+		list.alloc     = type->tp_alloc;
+		list.free      = type->tp_free;
+		list.nitems    = nitems;
+		list.n_block   = 0;
+		type->tp_alloc = freelist_alloc;
+		type->tp_free  = freelist_free;
+	}
+
+	size_t freelist_bytes(void)
+	{	size_t bytes = 0;
+		for(size_t i = 0; i < n_list_; i++)
+			bytes += list_[i].n_block * block_bytes(list_[i]);
+		return bytes;
+	}
+
+	size_t release_freelist(void)
+	{	size_t bytes = freelist_bytes();
+		for(size_t i = 0; i < n_list_; i++)
+		{	freelist& list = list_[i];
+			while( list.n_block > 0 )
+				list.free( list.block[ --list.n_block ] );
+		}
+		return bytes;
+	}
+}
@@ -0,0 +1,37 @@
+# ifndef PYCPPAD_FREELIST_INCLUDED
+# define PYCPPAD_FREELIST_INCLUDED
+
+# include "environment.hpp"
+
+/*
+A python a_float (or a2float) instance is created for the result of every
+operation during recording and most of them are freed soon afterwards.
+install_freelist<Type>() replaces the tp_alloc and tp_free functions of the
+python class that wraps Type so freed instances are held on a freelist
+and reused for the next instance of the same class.
+*/
+namespace pycppad {
+	// every block on the freelist for type has room for nitems
+	void install_freelist(PyTypeObject* type, Py_ssize_t nitems);
+
+	template <class Type>
+	void install_freelist(void)
+	{	using boost::python::converter::registered;
+		using boost::python::objects::additional_instance_size;
+		using boost::python::objects::value_holder;
+		PyTypeObject* type =
+			registered<Type>::converters.get_class_object();
+		Py_ssize_t nitems  = static_cast<Py_ssize_t>(
+			additional_instance_size< value_holder<Type> >::value
+		);
+		install_freelist(type, nitems);
+	}
+
+	// number of bytes held on the freelists
+	size_t freelist_bytes(void);
+
+	// return the freelist blocks to python and the number of bytes released
+	size_t release_freelist(void);
+}
+
+# endif
@@ -0,0 +1,117 @@
+# include "instrument.hpp"
+
+namespace pycppad {
+	boost::python::dict counters_disabled(void)
+	{	boost::python::dict result;
+		result["enabled"] = false;
+		return result;
+	}
+
+	boost::python::dict global_counters_dict(void)
+	{
+# ifdef PYCPPAD_INSTRUMENT
+		return global_counters().as_dict();
+# else
+		return counters_disabled();
+# endif
+	}
+
+	void reset_global_counters(void)
+	{
+# ifdef PYCPPAD_INSTRUMENT
+		global_counters().reset();
+# endif
+	}
+
+# ifdef PYCPPAD_INSTRUMENT
+	namespace {
+		boost::python::list vector2list(const std::vector<size_t>& v)
+		{	boost::python::list result;
+			for(size_t i = 0; i < v.size(); i++)
+				result.append(v[i]);
+			return result;
+		}
+		void count_sweep(std::vector<size_t>& sweep, size_t p)
+		{	if( sweep.size() <= p )
+				sweep.resize(p + 1, 0);
+			sweep[p]++;
+		}
+	}
+	// -------------------------------------------------------------------
+	// counters
+	counters::counters(void)
+	{	reset(); }
+
+	void counters::reset(void)
+	{	call  = 0;
+		bytes = 0;
+		for(size_t i = 0; i < number_probe_phase; i++)
+			us[i] = 0;
+		forward.clear();
+		reverse.clear();
+	}
+
+	boost::python::dict counters::as_dict(void) const
+	{	boost::python::dict result;
+		result["enabled"]    = true;
+		result["call"]       = call;
+		result["convert_us"] = us[phase_convert];
+		result["sweep_us"]   = us[phase_sweep];
+		result["output_us"]  = us[phase_output];
+		result["bytes"]      = bytes;
+		result["forward"]    = vector2list(forward);
+		result["reverse"]    = vector2list(reverse);
+		return result;
+	}
+
+	counters& global_counters(void)
+	{	static counters global;
+		return global;
+	}
+
+	size_t& allocated_bytes(void)
+	{	static size_t bytes = 0;
+		return bytes;
+	}
+	// -------------------------------------------------------------------
+	// probe
+	probe::probe(counters& local) : local_(local)
+	{	phase_ = phase_convert;
+		start_ = CppAD::elapsed_seconds();
+		bytes_ = allocated_bytes();
+	}
+
+	void probe::stop(void)
+	{	double now = CppAD::elapsed_seconds();
+		// elapsed_seconds has microsecond resolution
+		size_t us  = static_cast<size_t>( (now - start_) * 1e6 );
+		local_.us[phase_]              += us;
+		global_counters().us[phase_]   += us;
+		start_ = now;
+	}
+
+	probe::~probe(void)
+	{	stop();
+		size_t bytes = allocated_bytes() - bytes_;
+		local_.call++;
+		local_.bytes += bytes;
+		global_counters().call++;
+		global_counters().bytes += bytes;
+	}
+
+	void probe::phase(probe_phase p)
+	{	stop();
+		phase_ = p;
+	}
+
+	void probe::forward(size_t p)
+	{	count_sweep(local_.forward, p);
+		count_sweep(global_counters().forward, p);
+	}
+
+	void probe::reverse(size_t p)
+	{	count_sweep(local_.reverse, p);
+		count_sweep(global_counters().reverse, p);
+	}
+# endif
+}
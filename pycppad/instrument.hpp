@@ -0,0 +1,85 @@
+# ifndef PYCPPAD_INSTRUMENT_INCLUDED
+# define PYCPPAD_INSTRUMENT_INCLUDED
+
+# include "environment.hpp"
+# include <vector>
+
+/*
+The PYCPPAD_PROBE macros below expand to nothing unless PYCPPAD_INSTRUMENT 
+is defined during compilation (see instrument in setup.py).
+	PYCPPAD_PROBE(c)          start timing a call that is counted in c
+	PYCPPAD_PROBE_PHASE(p)    time from now on is charged to phase_p
+	PYCPPAD_PROBE_FORWARD(p)  a forward sweep of order p was done
+	PYCPPAD_PROBE_REVERSE(p)  a reverse sweep of order p was done
+	PYCPPAD_PROBE_BYTES(n)    n bytes were allocated for a pycppad vector
+*/
+# ifdef PYCPPAD_INSTRUMENT
+# define PYCPPAD_PROBE(c)         pycppad::probe probe_(c)
+# define PYCPPAD_PROBE_PHASE(p)   probe_.phase(pycppad::phase_##p)
+# define PYCPPAD_PROBE_FORWARD(p) probe_.forward(p)
+# define PYCPPAD_PROBE_REVERSE(p) probe_.reverse(p)
+# define PYCPPAD_PROBE_BYTES(n)   pycppad::allocated_bytes() += (n)
+# else
+# define PYCPPAD_PROBE(c)
+# define PYCPPAD_PROBE_PHASE(p)
+# define PYCPPAD_PROBE_FORWARD(p)
+# define PYCPPAD_PROBE_REVERSE(p)
+# define PYCPPAD_PROBE_BYTES(n)
+# endif
+
+namespace pycppad {
+	// python dictionary that reports instrumentation is not enabled
+	boost::python::dict counters_disabled(void);
+
+	// python interface to the global counters
+	boost::python::dict global_counters_dict(void);
+	void reset_global_counters(void);
+
+# ifdef PYCPPAD_INSTRUMENT
+	// parts of a call that are timed separately
+	enum probe_phase {
+		phase_convert,   // converting arguments from python to C++
+		phase_sweep,     // CppAD forward and reverse sweeps
+		phase_output,    // converting results from C++ to python
+		number_probe_phase
+	};
+
+	// counters for one adfun object, or for all of them (global_counters)
+	class counters {
+	public:
+		size_t              call;    // number of calls
+		size_t              us[number_probe_phase]; // microseconds per phase
+		size_t              bytes;   // bytes allocated for pycppad vectors
+		std::vector<size_t> forward; // forward[p] = forward sweeps of order p
+		std::vector<size_t> reverse; // reverse[p] = reverse sweeps of order p
+		counters(void);
+		void reset(void);
+		boost::python::dict as_dict(void) const;
+	};
+
+	// counters summed over all the adfun objects
+	counters& global_counters(void);
+
+	// total bytes allocated for pycppad vectors
+	size_t& allocated_bytes(void);
+
+	// Times one call; the time and bytes are added to the local and
+	// global counters when the probe is destroyed.
+	class probe {
+	private:
+		counters&   local_;
+		probe_phase phase_;
+		double      start_;
+		size_t      bytes_;
+		void        stop(void);
+	public:
+		probe(counters& local);
+		~probe(void);
+		void phase(probe_phase p);
+		void forward(size_t p);
+		void reverse(size_t p);
+	};
+# endif
+}
+
+# endif
@@ -0,0 +1,82 @@
+# include "memory.hpp"
+# include "freelist.hpp"
+
+namespace pycppad {
+	namespace {
+		// current and peak values for each thread
+		size_t scratch_[CPPAD_MAX_NUM_THREADS];
+		size_t peak_inuse_[CPPAD_MAX_NUM_THREADS];
+		size_t peak_scratch_[CPPAD_MAX_NUM_THREADS];
+	}
+
+	size_t& scratch_bytes(void)
+	{	return scratch_[ CppAD::thread_alloc::thread_num() ];
+	}
+
+	void sample_memory(void)
+	{	using CppAD::thread_alloc;
+		size_t thread = thread_alloc::thread_num();
+		size_t inuse  = thread_alloc::inuse(thread);
+		if( peak_inuse_[thread] < inuse )
+			peak_inuse_[thread] = inuse;
+		if( peak_scratch_[thread] < scratch_bytes() )
+			peak_scratch_[thread] = scratch_bytes();
+	}
+
+	boost::python::dict memory_dict(void)
+	{	using CppAD::thread_alloc;
+		sample_memory();
+		boost::python::list thread_list;
+		size_t total_inuse     = 0;
+		size_t total_available = 0;
+		size_t total_peak      = 0;
+		size_t total_scratch   = 0;
+		size_t n_thread        = thread_alloc::num_threads();
+		for(size_t thread = 0; thread < n_thread; thread++)
+		{	boost::python::dict d;
+			size_t inuse     = thread_alloc::inuse(thread);
+			size_t available = thread_alloc::available(thread);
+			d["inuse"]        = inuse;
+			d["available"]    = available;
+			d["peak_inuse"]   = peak_inuse_[thread];
+			d["scratch"]      = scratch_[thread];
+			d["peak_scratch"] = peak_scratch_[thread];
+			thread_list.append(d);
+			total_inuse     += inuse;
+			total_available += available;
+			total_peak      += peak_inuse_[thread];
+			total_scratch   += scratch_[thread];
+		}
+		boost::python::dict result;
+		result["inuse"]      = total_inuse;
+		result["available"]  = total_available;
+		result["peak_inuse"] = total_peak;
+		result["scratch"]    = total_scratch;
+		result["freelist"]   = freelist_bytes();
+		result["thread"]     = thread_list;
+		return result;
+	}
+
+	size_t release_memory(void)
+	{	using CppAD::thread_alloc;
+		size_t released = release_freelist();
+		size_t n_thread = thread_alloc::num_threads();
+		for(size_t thread = 0; thread < n_thread; thread++)
+		{	released += thread_alloc::available(thread);
+			thread_alloc::free_available(thread);
+		}
+		return released;
+	}
+
+	void reset_peak_memory(void)
+	{	using CppAD::thread_alloc;
+		size_t n_thread = thread_alloc::num_threads();
+		for(size_t thread = 0; thread < n_thread; thread++)
+		{	peak_inuse_[thread]   = thread_alloc::inuse(thread);
+			peak_scratch_[thread] = scratch_[thread];
+		}
+	}
+
+	void hold_memory(bool value)
+	{	CppAD::thread_alloc::hold_memory(value); }
+}
@@ -0,0 +1,39 @@
+# ifndef PYCPPAD_MEMORY_INCLUDED
+# define PYCPPAD_MEMORY_INCLUDED
+
+# include "environment.hpp"
+# include "instrument.hpp"
+
+namespace pycppad {
+	// bytes currently in use for pycppad vectors by the current thread
+	size_t& scratch_bytes(void);
+
+	// record the current memory use of this thread in its peak values
+	void sample_memory(void);
+
+	// allocate and free the memory for pycppad vectors; these go through
+	// CppAD::thread_alloc so freed memory can be reused by the same thread
+	template <class Type>
+	Type* new_scratch(size_t length)
+	{	size_t capacity;
+		Type*  array = CppAD::thread_alloc::create_array<Type>(
+			length, capacity
+		);
+		scratch_bytes() += length * sizeof(Type);
+		PYCPPAD_PROBE_BYTES( length * sizeof(Type) );
+		return array;
+	}
+	template <class Type>
+	void delete_scratch(Type* array, size_t length)
+	{	scratch_bytes() -= length * sizeof(Type);
+		CppAD::thread_alloc::delete_array(array);
+	}
+
+	// python interface
+	boost::python::dict memory_dict(void);
+	size_t release_memory(void);
+	void   reset_peak_memory(void);
+	void   hold_memory(bool value);
+}
+
+# endif
@@ -0,0 +1,106 @@
+# include "op_count.hpp"
+
+namespace pycppad {
+	const char* op_type_name[number_op_type] = {
+		"add",
+		"sub",
+		"mul",
+		"div",
+		"neg",
+		"pow",
+		"abs",
+		"arccos",
+		"arcsin",
+		"arctan",
+		"cos",
+		"cosh",
+		"exp",
+		"log",
+		"log10",
+		"sin",
+		"sinh",
+		"sqrt",
+		"tan",
+		"tanh",
+		"condexp",
+		"atomic"
+	};
+
+	const double op_type_cost[number_op_type] = {
+		1.,  // add
+		1.,  // sub
+		1.,  // mul
+		2.,  // div
+		1.,  // neg
+		12., // pow (recorded as log, mul and exp)
+		1.,  // abs
+		10., // arccos
+		10., // arcsin
+		8.,  // arctan
+		6.,  // cos
+		6.,  // cosh
+		5.,  // exp
+		5.,  // log
+		6.,  // log10
+		6.,  // sin
+		6.,  // sinh
+		3.,  // sqrt
+		8.,  // tan
+		8.,  // tanh
+		2.,  // condexp
+		50.  // atomic (depends on the dimensions)
+	};
+
+	std::vector<std::string>& record_label_name(void)
+	{	static std::vector<std::string> name(1, std::string(""));
+		return name;
+	}
+
+	size_t& current_record_label(void)
+	{	static size_t label[CPPAD_MAX_NUM_THREADS];
+		return label[ thread_number() ];
+	}
+
+	void record_label(const std::string& name)
+	{	std::vector<std::string>& label_name = record_label_name();
+		size_t label = 0;
+		while( label < label_name.size() && label_name[label] != name )
+			label++;
+		if( label == label_name.size() )
+			label_name.push_back(name);
+		current_record_label() = label;
+	}
+
+	boost::python::dict op_count2dict(const std::vector<size_t>& count)
+	{	PYCPPAD_ASSERT( count.size() % number_op_type == 0, "");
+		boost::python::dict result;
+		for(size_t i = 0; i < number_op_type; i++)
+		{	size_t sum = 0;
+			for(size_t k = i; k < count.size(); k += number_op_type)
+				sum += count[k];
+			if( sum != 0 )
+				result[ op_type_name[i] ] = sum;
+		}
+		return result;
+	}
+
+	boost::python::dict op_count2label_dict(const std::vector<size_t>& count)
+	{	PYCPPAD_ASSERT( count.size() % number_op_type == 0, "");
+		boost::python::dict result;
+		size_t n_label = count.size() / number_op_type;
+		for(size_t label = 0; label < n_label; label++)
+		{	boost::python::dict label_count;
+			bool   empty = true;
+			for(size_t i = 0; i < number_op_type; i++)
+			{	size_t c = count[label * number_op_type + i];
+				if( c != 0 )
+				{	label_count[ op_type_name[i] ] = c;
+					empty = false;
+				}
+			}
+			if( ! empty )
+				result[ record_label_name()[label] ] = label_count;
+		}
+		return result;
+	}
+}
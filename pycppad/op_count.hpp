@@ -0,0 +1,85 @@
+# ifndef PYCPPAD_OP_COUNT_INCLUDED
+# define PYCPPAD_OP_COUNT_INCLUDED
+
+# include "environment.hpp"
+# include "threads.hpp"
+# include <vector>
+
+namespace pycppad {
+	// ------------------------------------------------------------------
+	// types of operations that are counted while recording
+	enum op_type {
+		op_add,
+		op_sub,
+		op_mul,
+		op_div,
+		op_neg,
+		op_pow,
+		op_abs,
+		op_acos,
+		op_asin,
+		op_atan,
+		op_cos,
+		op_cosh,
+		op_exp,
+		op_log,
+		op_log10,
+		op_sin,
+		op_sinh,
+		op_sqrt,
+		op_tan,
+		op_tanh,
+		op_condexp,
+		op_atomic,
+		number_op_type
+	};
+	// name used for each op_type in python dictionaries
+	extern const char* op_type_name[number_op_type];
+
+	// rough cost of each op_type during a sweep relative to op_add
+	extern const double op_type_cost[number_op_type];
+
+	// Recording labels set by record_label; the index of a label in 
+	// record_label_name() never changes and index zero is the empty label.
+	// The current label is kept for each recording thread number.
+	std::vector<std::string>& record_label_name(void);
+	size_t& current_record_label(void);
+	void record_label(const std::string& name);
+
+	// Number of operations of each type, for each recording label, that 
+	// have been recorded using AD<Base> since the last call to independent 
+	// that started an AD<Base> recording in this thread (only operations
+	// that have a variable operand are counted). The count for op in label
+	// is op_count<Base>()[ label * number_op_type + op ].
+	template <class Base>
+	std::vector<size_t>& op_count(void)
+	{	static std::vector<size_t> count[CPPAD_MAX_NUM_THREADS];
+		return count[ thread_number() ];
+	}
+	template <class Base>
+	void reset_op_count(void)
+	{	op_count<Base>().clear();
+		current_record_label() = 0;
+	}
+	template <class Base>
+	inline void count_op(op_type op, bool variable)
+	{	if( variable )
+		{	std::vector<size_t>& count = op_count<Base>();
+			size_t label = current_record_label();
+			size_t index = label * number_op_type + op;
+			if( count.size() <= index )
+				count.resize( (label + 1) * number_op_type, 0);
+			count[index]++;
+		}
+	}
+
+	// python dictionary with the non-zero counts in count summed over labels
+	boost::python::dict op_count2dict(const std::vector<size_t>& count);
+
+	// python dictionary that maps each label name to the python dictionary
+	// with the non-zero counts for that label (labels without counts are 
+	// not included).
+	boost::python::dict op_count2label_dict(const std::vector<size_t>& count);
+}
+
+# endif
@@ -433,6 +433,7 @@ $$
 
 $section Conditional Expressions$$
 $index abs$$
+$index condexp, array$$
 
 $head Syntax$$
 $icode%result% = condexp_%rel%(%left%, %right%, %if_true%, %if_false%)%$$
@@ -477,6 +478,19 @@ It specifies the return value if the result of the comparison is false.
 $head result$$
 This result has the same type as $icode left$$.
 
+$head Arrays$$
+The arguments may also be $code numpy.array$$ objects with the same shape
+(or with one element, which is then used for every element of the result).
+Their elements can be $code int$$, $code float$$, and either
+$code a_float$$ or $code a2float$$ (but not both),
+and at least one element must be an $code a_float$$ or $code a2float$$.
+In this case $icode result$$ is an array with the shape of the arguments,
+and all of its conditional expressions are recorded in one C++ loop.
+Both the $icode if_true$$ and $icode if_false$$ values are recorded for
+every element, so the operation sequence does not depend on the
+result of the comparisons and need not be recorded again 
+when they change.
+
 $children%
 	example/condexp.py
 %$$
@@ -485,118 +499,414 @@ The file $cref condexp.py$$
 contains an example and test of these functions.
 $end
 ---------------------------------------------------------------------------
+$begin vector_op$$
+$spell
+	numpy
+	vabs
+	varccos
+	varcsin
+	varctan
+	vcos
+	vcosh
+	vexp
+	vlog
+	vsin
+	vsinh
+	vsqrt
+	vtan
+	vtanh
+	vadd
+	vsub
+	vmul
+	vdiv
+	vsum
+	vdot
+	op
+$$
+
+$section Array Operations Recorded in One Call$$
+
+$index vector, operation$$
+$index array, operation$$
+$index vsum$$
+$index vdot$$
+$index vadd$$
+$index vsin$$
+
+$head Syntax$$
+$icode%y% = v%fun%(%x%)
+%$$
+$icode%z% = v%op%(%x%, %y%)
+%$$
+$icode%s% = vsum(%x%)
+%$$
+$icode%d% = vdot(%a%, %b%)%$$
+
+$head Purpose$$
+Each of these functions records all of its element operations 
+in one C++ loop.
+This is faster than the corresponding python expressions, 
+where every element operation is a separate python call.
+The operations that are recorded are the same.
+
+$head Operands$$
+The operands $icode x$$, $icode y$$, $icode a$$ and $icode b$$
+can be $code numpy.array$$ objects (of any shape), lists, or scalars.
+Their elements can be $code int$$, $code float$$, and
+either $code a_float$$ or $code a2float$$ (but not both).
+At least one element of the operands must be an $code a_float$$ or 
+$code a2float$$; otherwise $code NotImplementedError$$ is raised
+(use the $code numpy$$ functions for $code float$$ values).
+The AD type of the results is the AD type of the operands.
+
+$head fun$$
+The element by element function $icode fun$$ is one of
+$code abs$$, 
+$code arccos$$,
+$code arcsin$$,
+$code arctan$$,
+$code cos$$,
+$code cosh$$,
+$code exp$$,
+$code log$$,
+$code log10$$,
+$code sin$$,
+$code sinh$$,
+$code sqrt$$,
+$code tan$$, or
+$code tanh$$.
+The result $icode y$$ has the same shape as $icode x$$
+(it is a scalar if $icode x$$ is a scalar).
+
+$head op$$
+The element by element binary operation $icode op$$ is one of
+$code add$$, $code sub$$, $code mul$$, or $code div$$.
+The operands $icode x$$ and $icode y$$ must have the same shape,
+or one of them must have one element 
+(which is then used with every element of the other).
+The result $icode z$$ has the shape of the larger operand.
+
+$head vsum$$
+The result $icode s$$ is the sum of all the elements of $icode x$$.
+
+$head vdot$$
+The operand $icode b$$ must be a vector.
+If $icode a$$ is a vector with the same length as $icode b$$,
+$icode d$$ is their inner product.
+If $icode a$$ is a matrix with as many columns as $icode b$$ has elements,
+$icode d$$ is the vector $icode%a% * %b%$$.
+Products where one of the factors is a constant zero are not recorded.
+
+$children%
+	example/vector_op.py
+%$$
+$head Example$$
+The file $cref vector_op.py$$ 
+contains an example and test of these functions.
+$end
+---------------------------------------------------------------------------
+$begin linear_algebra$$
+$spell
+	numpy
+	matmul
+	lu
+	Cholesky
+	op
+	dict
+$$
+
+$section Dense Linear Algebra Recorded as One Operation$$
+
+$index matmul$$
+$index lu_solve$$
+$index cholesky_solve$$
+$index atomic, linear algebra$$
+$index linear algebra, atomic$$
+
+$head Syntax$$
+$icode%c% = matmul(%a%, %b%)
+%$$
+$icode%y% = lu_solve(%a%, %b%)
+%$$
+$icode%y% = cholesky_solve(%a%, %b%)%$$
+
+$head Purpose$$
+Each of these functions is recorded as one CppAD atomic operation
+(instead of one operation for every scalar multiply and add).
+Its forward and reverse mode derivatives are computed by dense 
+matrix routines.
+This reduces the size of the operation sequence, and the time for the
+sweeps, from order $latex n^2$$ (or $latex n^3$$) operations to one
+operation for each call.
+
+$head Operands$$
+The operands $icode a$$ and $icode b$$ are $code numpy.array$$ objects
+(or lists).
+Their elements can be $code int$$, $code float$$, and
+either $code a_float$$ or $code a2float$$ (but not both).
+At least one element must be an $code a_float$$ or $code a2float$$;
+otherwise $code NotImplementedError$$ is raised.
+The AD type of the results is the AD type of the operands.
+
+$head matmul$$
+The result $icode c$$ is the matrix product $icode%a% * %b%$$.
+Each of $icode a$$ and $icode b$$ can be a vector or a matrix and
+the number of columns in $icode a$$
+must equal the number of rows in $icode b$$ (as for $code numpy.dot$$).
+
+$head lu_solve$$
+The matrix $icode a$$ must be square and invertible,
+$icode b$$ is a vector or a matrix with as many rows as $icode a$$,
+and $icode y$$ is the solution of $icode%a% * %y% = %b%$$.
+It has the same shape as $icode b$$.
+An LU factorization with partial pivoting is used.
+
+$head cholesky_solve$$
+Is the same as $code lu_solve$$ except that $icode a$$ must be
+symmetric and positive definite, and only its lower triangle is used
+(the elements above the diagonal are not referenced and have
+derivative zero).
+
+$head Operation Count$$
+Each call that has a variable operand is counted as one
+$code atomic$$ operation in the 
+$cref/recorded_op/stats/recorded_op/$$ dictionary.
+
+$children%
+	example/linear_algebra.py
+%$$
+$head Example$$
+The file $cref linear_algebra.py$$ 
+contains an example and test of these functions.
+$end
+---------------------------------------------------------------------------
+$begin reduce$$
+$spell
+	numpy
+	sumsq
+	op
+	dict
+$$
+
+$section Reductions Recorded as One Operation$$
+
+$index reduce_sum$$
+$index reduce_sumsq$$
+$index reduce_dot$$
+$index sum, reduction$$
+$index weighted, sum$$
+$index least squares, objective$$
+
+$head Syntax$$
+$icode%s% = reduce_sum(%x%)
+%$$
+$icode%s% = reduce_sumsq(%x%)
+%$$
+$icode%s% = reduce_dot(%x%, %y%)%$$
+
+$head Purpose$$
+The sum of $latex n$$ values recorded using $code +$$ 
+(or $code numpy.sum$$ or $cref/vsum/vector_op/vsum/$$) is $latex n-1$$ operations,
+each with its own variable and Taylor coefficients.
+These functions record the reduction as one n-ary operation
+(a CppAD atomic operation) with one result variable.
+The forward and reverse sweeps treat it as one node.
+
+$head Operands$$
+The operands $icode x$$ and $icode y$$ are $code numpy.array$$ objects
+(of any shape), lists, or scalars.
+Their elements can be $code int$$, $code float$$, and
+either $code a_float$$ or $code a2float$$ (but not both).
+The result $icode s$$ has the AD type of the operands.
+If no element is an $code a_float$$ or $code a2float$$,
+nothing is recorded and $icode s$$ is a $code float$$
+equal to the corresponding $code numpy$$ result; e.g.,
+$codei%numpy.dot(%x%, %y%)%$$ for vectors $icode x$$ and $icode y$$.
+
+$head reduce_sum$$
+The result is the sum of the elements of $icode x$$.
+
+$head reduce_sumsq$$
+The result is the sum of the squares of the elements of $icode x$$;
+for example a least squares objective where $icode x$$ are the residuals.
+
+$head reduce_dot$$
+The operands must have the same number of elements and
+the result is the sum of the products of corresponding elements.
+
+$head Weighted Sums$$
+If $icode x$$ has $code float$$ elements (the weights) 
+and $icode y$$ has AD elements,
+$codei%reduce_dot(%x%, %y%)%$$ is the corresponding weighted sum.
+
+$head Operation Count$$
+Each call is counted as one $code atomic$$ operation in the 
+$cref/recorded_op/stats/recorded_op/$$ dictionary.
+
+$children%
+	example/reduce.py
+%$$
+$head Example$$
+The file $cref reduce.py$$ 
+contains an example and test of these functions.
+$end
+---------------------------------------------------------------------------
 */
 # include "environment.hpp"
 # include "vector.hpp"
 # include "vec2array.hpp"
 # include "adfun.hpp"
+# include "op_count.hpp"
+# include "freelist.hpp"
+# include "atomic.hpp"
+# include "threads.hpp"
 
 # define PY_ARRAY_UNIQUE_SYMBOL PyArray_Pycppad
 
-CppAD::AD<double> *truediv1(const CppAD::AD<double> &lhs, const CppAD::AD<double> &rhs){ return new CppAD::AD<double>(operator/(lhs,rhs));}
-CppAD::AD<double> *truediv2(const CppAD::AD<double> &lhs, const double &rhs){ return new CppAD::AD<double>(operator/(lhs,rhs));}
-CppAD::AD<double> *truediv3(const CppAD::AD<double> &rhs, const double &lhs){ return new CppAD::AD<double>(operator/(lhs,rhs));}
+namespace pycppad {
+	// -------------------------------------------------------------
+	// Wrappers for the AD<Base> operators and functions that are linked
+	// to python. They count the operations that get recorded; see op_count.
+	template <class Base>
+	struct op_wrap {
+		typedef CppAD::AD<Base> AD;
+
+		static void count(op_type op, const AD& x)
+		{	count_op<Base>(op, CppAD::Variable(x) ); }
+		static void count(op_type op, const AD& x, const AD& y)
+		{	count_op<Base>(op, CppAD::Variable(x) || CppAD::Variable(y) ); }
+
+		// unary operators
+		static AD neg(const AD& x)
+		{	count(op_neg, x); return - x; }
+		static AD pos(const AD& x)
+		{	return + x; }
+		static AD abs(const AD& x)
+		{	count(op_abs, x); return CppAD::abs(x); }
+
+		// binary operators and the corresponding computed assignments
+# define PYCPPAD_BINARY_WRAP(name, op, type)              \
+		static AD name(const AD& x, const AD& y)           \
+		{	count(type, x, y); return x op y; }           \
+		static AD name##_d(const AD& x, const double& y)   \
+		{	count(type, x); return x op y; }              \
+		static AD r##name##_d(const AD& y, const double& x)\
+		{	count(type, y); return x op y; }              \
+		static void i##name(AD& x, const AD& y)            \
+		{	count(type, x, y); x op##= y; }               \
+		static void i##name##_d(AD& x, const double& y)    \
+		{	count(type, x); x op##= y; }
+		PYCPPAD_BINARY_WRAP(add, +, op_add)
+		PYCPPAD_BINARY_WRAP(sub, -, op_sub)
+		PYCPPAD_BINARY_WRAP(mul, *, op_mul)
+		PYCPPAD_BINARY_WRAP(div, /, op_div)
+# undef PYCPPAD_BINARY_WRAP
+
+		// pow
+		static AD pow(const AD& x, const AD& y)
+		{	count(op_pow, x, y); return CppAD::pow(x, y); }
+		static AD pow_d(const AD& x, const double& y)
+		{	count(op_pow, x); return CppAD::pow(x, y); }
+		static AD pow_i(const AD& x, const int& y)
+		{	count(op_pow, x); return CppAD::pow(x, y); }
+		static AD rpow_d(const AD& y, const double& x)
+		{	count(op_pow, y); return CppAD::pow(x, y); }
+
+		// standard math functions
+# define PYCPPAD_UNARY_WRAP(name)                         \
+		static AD name(const AD& x)                        \
+		{	count(op_##name, x); return CppAD::name(x); }
+		PYCPPAD_UNARY_WRAP(acos)
+		PYCPPAD_UNARY_WRAP(asin)
+		PYCPPAD_UNARY_WRAP(atan)
+		PYCPPAD_UNARY_WRAP(cos)
+		PYCPPAD_UNARY_WRAP(cosh)
+		PYCPPAD_UNARY_WRAP(exp)
+		PYCPPAD_UNARY_WRAP(log)
+		PYCPPAD_UNARY_WRAP(log10)
+		PYCPPAD_UNARY_WRAP(sin)
+		PYCPPAD_UNARY_WRAP(sinh)
+		PYCPPAD_UNARY_WRAP(sqrt)
+		PYCPPAD_UNARY_WRAP(tan)
+		PYCPPAD_UNARY_WRAP(tanh)
+# undef PYCPPAD_UNARY_WRAP
+
+		// conditional expressions
+# define PYCPPAD_COND_EXP_WRAP(Name, name)                      \
+		static AD condexp_##name(                                \
+			const AD &left     ,                                 \
+			const AD &right    ,                                 \
+			const AD &if_true  ,                                 \
+			const AD &if_false )                                 \
+		{	count(op_condexp, left, right);                     \
+			return CppAD::CondExp##Name(                        \
+				left, right, if_true, if_false                  \
+			);                                                  \
+		}
+		PYCPPAD_COND_EXP_WRAP(Lt, lt)
+		PYCPPAD_COND_EXP_WRAP(Le, le)
+		PYCPPAD_COND_EXP_WRAP(Eq, eq)
+		PYCPPAD_COND_EXP_WRAP(Ge, ge)
+		PYCPPAD_COND_EXP_WRAP(Gt, gt)
+# undef PYCPPAD_COND_EXP_WRAP
+	};
+}
+
+CppAD::AD<double> truediv1(const CppAD::AD<double> &lhs, const CppAD::AD<double> &rhs){ return pycppad::op_wrap<double>::div(lhs,rhs);}
+CppAD::AD<double> truediv2(const CppAD::AD<double> &lhs, const double &rhs){ return pycppad::op_wrap<double>::div_d(lhs,rhs);}
+CppAD::AD<double> truediv3(const CppAD::AD<double> &rhs, const double &lhs){ return pycppad::op_wrap<double>::rdiv_d(rhs,lhs);}
 
 
-# define PYCPPAD_BINARY(op)       \
+# define PYCPPAD_BINARY(name, Base)                                         \
+     .def("__" #name "__",  pycppad::op_wrap<Base>::name)                 \
+     .def("__r" #name "__", pycppad::op_wrap<Base>::r##name##_d)          \
+     .def("__" #name "__",  pycppad::op_wrap<Base>::name##_d)             \
+     .def("__i" #name "__", pycppad::op_wrap<Base>::i##name,    return_self<>()) \
+     .def("__i" #name "__", pycppad::op_wrap<Base>::i##name##_d, return_self<>())
+
+# define PYCPPAD_COMPARE(op)      \
      .def(self     op self)       \
      .def(double() op self)       \
      .def(self     op double())
 
 
-# define PYCPPAD_OPERATOR_LIST \
-     .def(- self)              \
-     .def(+ self)              \
-                               \
-     PYCPPAD_BINARY(+)         \
-     PYCPPAD_BINARY(-)         \
-     PYCPPAD_BINARY(*)         \
-     PYCPPAD_BINARY(/)         \
-                               \
-     PYCPPAD_BINARY(<)         \
-     PYCPPAD_BINARY(>)         \
-     PYCPPAD_BINARY(<=)        \
-     PYCPPAD_BINARY(>=)        \
-     PYCPPAD_BINARY(==)        \
-     PYCPPAD_BINARY(!=)        \
-                               \
-     .def(self += self)        \
-     .def(self -= self)        \
-     .def(self *= self)        \
-     .def(self /= self)        \
-                               \
-     .def(self += double())    \
-     .def(self -= double())    \
-     .def(self *= double())    \
-     .def(self /= double()) 
-
-# define PYCPPAD_UNARY_FUNCTION(Name, Base)                              \
-     CppAD::AD<Base> (* Name##_AD_##Base ) (const CppAD::AD<Base> &x ) = \
-          CppAD::Name; 
-
-# define PYCPPAD_STD_MATH_LINK_CPP(Base)   \
-     PYCPPAD_UNARY_FUNCTION(acos,  Base)   \
-     PYCPPAD_UNARY_FUNCTION(asin,  Base)   \
-     PYCPPAD_UNARY_FUNCTION(atan,  Base)   \
-     PYCPPAD_UNARY_FUNCTION(cos,   Base)   \
-     PYCPPAD_UNARY_FUNCTION(cosh,  Base)   \
-     PYCPPAD_UNARY_FUNCTION(exp,   Base)   \
-     PYCPPAD_UNARY_FUNCTION(log,   Base)   \
-     PYCPPAD_UNARY_FUNCTION(log10, Base)   \
-     PYCPPAD_UNARY_FUNCTION(sin,   Base)   \
-     PYCPPAD_UNARY_FUNCTION(sinh,  Base)   \
-     PYCPPAD_UNARY_FUNCTION(sqrt,  Base)   \
-     PYCPPAD_UNARY_FUNCTION(tan,   Base)   \
-     PYCPPAD_UNARY_FUNCTION(tanh,  Base) 
-
-# define PYCPPAD_STD_MATH_LINK_PY(Base)  \
-     .def("arccos",  acos_AD_##Base)     \
-     .def("arcsin",  asin_AD_##Base)     \
-     .def("arctan",  atan_AD_##Base)     \
-     .def("cos",     cos_AD_##Base)      \
-     .def("cosh",    cosh_AD_##Base)     \
-     .def("exp",     exp_AD_##Base)      \
-     .def("log",     log_AD_##Base)      \
-     .def("log10",   log10_AD_##Base)    \
-     .def("sin",     sin_AD_##Base)      \
-     .def("sinh",    sinh_AD_##Base)     \
-     .def("sqrt",    sqrt_AD_##Base)     \
-     .def("tan",     tan_AD_##Base)      \
-     .def("tanh",    tanh_AD_##Base)
-
-# define PYCPPAD_COND_EXP_LINK_CPP(Base) \
-     CppAD::AD<Base> (* condexp_lt_AD_##Base ) (                  \
-		const CppAD::AD<Base> &left     ,                       \
-		const CppAD::AD<Base> &right    ,                       \
-		const CppAD::AD<Base> &if_true  ,                       \
-		const CppAD::AD<Base> &if_false ) = CppAD::CondExpLt;   \
-     CppAD::AD<Base> (* condexp_le_AD_##Base ) (                  \
-		const CppAD::AD<Base> &left     ,                       \
-		const CppAD::AD<Base> &right    ,                       \
-		const CppAD::AD<Base> &if_true  ,                       \
-		const CppAD::AD<Base> &if_false ) = CppAD::CondExpLe;   \
-     CppAD::AD<Base> (* condexp_eq_AD_##Base ) (                  \
-		const CppAD::AD<Base> &left     ,                       \
-		const CppAD::AD<Base> &right    ,                       \
-		const CppAD::AD<Base> &if_true  ,                       \
-		const CppAD::AD<Base> &if_false ) = CppAD::CondExpEq;   \
-     CppAD::AD<Base> (* condexp_ge_AD_##Base ) (                  \
-		const CppAD::AD<Base> &left     ,                       \
-		const CppAD::AD<Base> &right    ,                       \
-		const CppAD::AD<Base> &if_true  ,                       \
-		const CppAD::AD<Base> &if_false ) = CppAD::CondExpGe;   \
-     CppAD::AD<Base> (* condexp_gt_AD_##Base ) (                  \
-		const CppAD::AD<Base> &left     ,                       \
-		const CppAD::AD<Base> &right    ,                       \
-		const CppAD::AD<Base> &if_true  ,                       \
-		const CppAD::AD<Base> &if_false ) = CppAD::CondExpGt;
-
-# define PYCPPAD_COND_EXP_LINK_PY(Base) \
-	def("condexp_lt", condexp_lt_AD_##Base); \
-	def("condexp_le", condexp_le_AD_##Base); \
-	def("condexp_eq", condexp_eq_AD_##Base); \
-	def("condexp_ge", condexp_ge_AD_##Base); \
-	def("condexp_gt", condexp_gt_AD_##Base);
+# define PYCPPAD_OPERATOR_LIST(Base)                         \
+     .def("__neg__", pycppad::op_wrap<Base>::neg)            \
+     .def("__pos__", pycppad::op_wrap<Base>::pos)            \
+                                                             \
+     PYCPPAD_BINARY(add, Base)                               \
+     PYCPPAD_BINARY(sub, Base)                               \
+     PYCPPAD_BINARY(mul, Base)                               \
+     PYCPPAD_BINARY(div, Base)                               \
+                                                             \
+     PYCPPAD_COMPARE(<)                                      \
+     PYCPPAD_COMPARE(>)                                      \
+     PYCPPAD_COMPARE(<=)                                     \
+     PYCPPAD_COMPARE(>=)                                     \
+     PYCPPAD_COMPARE(==)                                     \
+     PYCPPAD_COMPARE(!=)
+
+# define PYCPPAD_STD_MATH_LINK_PY(Base)                    \
+     .def("arccos",  pycppad::op_wrap<Base>::acos)         \
+     .def("arcsin",  pycppad::op_wrap<Base>::asin)         \
+     .def("arctan",  pycppad::op_wrap<Base>::atan)         \
+     .def("cos",     pycppad::op_wrap<Base>::cos)          \
+     .def("cosh",    pycppad::op_wrap<Base>::cosh)         \
+     .def("exp",     pycppad::op_wrap<Base>::exp)          \
+     .def("log",     pycppad::op_wrap<Base>::log)          \
+     .def("log10",   pycppad::op_wrap<Base>::log10)        \
+     .def("sin",     pycppad::op_wrap<Base>::sin)          \
+     .def("sinh",    pycppad::op_wrap<Base>::sinh)         \
+     .def("sqrt",    pycppad::op_wrap<Base>::sqrt)         \
+     .def("tan",     pycppad::op_wrap<Base>::tan)          \
+     .def("tanh",    pycppad::op_wrap<Base>::tanh)
+
+# define PYCPPAD_COND_EXP_LINK_PY(Base)                        \
+	def("condexp_lt", pycppad::op_wrap<Base>::condexp_lt); \
+	def("condexp_le", pycppad::op_wrap<Base>::condexp_le); \
+	def("condexp_eq", pycppad::op_wrap<Base>::condexp_eq); \
+	def("condexp_ge", pycppad::op_wrap<Base>::condexp_ge); \
+	def("condexp_gt", pycppad::op_wrap<Base>::condexp_gt);
 
 
 namespace pycppad {
@@ -622,30 +932,776 @@ namespace pycppad {
 	{	// Use the Python 'C' API to set up an exception object
 		PyErr_SetString(PyExc_ValueError, e.what());
 	}
+	void translate_not_implemented(pycppad::not_implemented const& e)
+	{	PyErr_SetString(PyExc_NotImplementedError, e.what()); }
+	// -------------------------------------------------------------
+	// type of an element in an array that is passed to independent or adfun
+	enum element_type {
+		element_int,
+		element_float,
+		element_a_float,
+		element_a2float,
+		element_other
+	};
+	const char* element_type_name[] = {
+		"int", "float", "a_float", "a2float", "other"
+	};
+	static element_type element(PyObject* p)
+	{	using boost::python::converter::registered;
+		static PyTypeObject* a_float_type = 
+			registered<AD_double>::converters.get_class_object();
+		static PyTypeObject* a2float_type = 
+			registered<AD_AD_double>::converters.get_class_object();
+# if PY_MAJOR_VERSION < 3
+		if( PyInt_Check(p) )
+			return element_int;
+# endif
+		if( PyLong_Check(p) )
+			return element_int;
+		if( PyFloat_Check(p) )
+			return element_float;
+		if( PyObject_TypeCheck(p, a_float_type) )
+			return element_a_float;
+		if( PyObject_TypeCheck(p, a2float_type) )
+			return element_a2float;
+		return element_other;
+	}
+	// Check that all the elements of the vector v have type t and
+	// throw not_implemented, with a message that starts with name,
+	// if they do not.
+	static void check_elements(
+		const char*   name  ,
+		const char*   v_name,
+		PyArrayObject* v    ,
+		element_type  t     )
+	{	size_t  n   = static_cast<size_t>( PyArray_DIMS(v)[0] );
+		object* obj = static_cast<object*>( PyArray_DATA(v) );
+		for(size_t j = 0; j < n; j++)
+		{	if( element( obj[j].ptr() ) != t )
+			{	std::stringstream msg;
+				msg << name << ": mixed types x[0] is "
+				    << element_type_name[t] << " and "
+				    << v_name << "[" << j << "] is "
+				    << Py_TYPE( obj[j].ptr() )->tp_name;
+				throw not_implemented( msg.str().c_str() );
+			}
+		}
+	}
+	// Contiguous numpy vector equal to x, or not_implemented is thrown.
+	static array numpy_vector(const char* msg, object& x)
+	{	if( ! PyArray_Check( x.ptr() ) )
+			throw not_implemented(msg);
+		PyArrayObject* p = reinterpret_cast<PyArrayObject*>( x.ptr() );
+		PYCPPAD_ASSERT( 
+			PyArray_NDIM(p) == 1,
+			"independent or adfun: array is not a vector"
+		);
+		return extract<array>( object( handle<>(
+			reinterpret_cast<PyObject*>( PyArray_GETCONTIGUOUS(p) )
+		) ) );
+	}
 	// -------------------------------------------------------------
-	// Kludge: Pass level to Independent until we know how to determine if 
-	// the elements are x_array are AD_double or AD_AD_double.
-	array Independent(array& x_array, int level)
-	{	PYCPPAD_ASSERT( 
-			level == 1 || level == 2,
-			"independent: level argument must be 1 or 2."
+	// The AD level of the independent variables is determined by the
+	// type of the elements of x.
+	array Independent(object x)
+	{	claim_thread_number();
+		array x_array = numpy_vector(
+			"independent(x): x is not of type numpy.array", x
 		);
-		if( level == 1 )
-		{
-			double_vec      x(x_array);
-			AD_double_vec a_x(x.size() );
-			for(size_t j = 0; j < x.size(); j++)
-				a_x[j] = x[j];
+		PyArrayObject* p = reinterpret_cast<PyArrayObject*>( x_array.ptr() );
+		size_t n    = static_cast<size_t>( PyArray_DIMS(p)[0] );
+		int    type = PyArray_TYPE(p);
+		const char* not_implemented_msg = "independent(x): "
+			"only implemented where x[j] is int, float, or a_float";
+		if( type != NPY_OBJECT )
+		{	if( type != NPY_DOUBLE && type != NPY_FLOAT &&
+			    type != NPY_INT    && type != NPY_LONG  )
+				throw not_implemented(not_implemented_msg);
+			double_vec    x_vec(x_array);
+			AD_double_vec a_x(n);
+			for(size_t j = 0; j < n; j++)
+				a_x[j] = x_vec[j];
 			CppAD::Independent(a_x);
+			set_recording(1, true);
+			reset_op_count<double>();
 			return vec2array(a_x);
 		}
-		AD_double_vec      x(x_array);
-		AD_AD_double_vec a_x(x.size() );
-		for(size_t j = 0; j < x.size(); j++)
-			a_x[j] = x[j];
+		PYCPPAD_ASSERT( n > 0, "independent(x): x has no elements" );
+		object*      obj = static_cast<object*>( PyArray_DATA(p) );
+		element_type t   = element( obj[0].ptr() );
+		if( t == element_a2float || t == element_other )
+			throw not_implemented(not_implemented_msg);
+		check_elements("independent(x)", "x", p, t);
+		if( t != element_a_float )
+		{	AD_double_vec a_x(n);
+			for(size_t j = 0; j < n; j++)
+				a_x[j] = PyFloat_AsDouble( obj[j].ptr() );
+			CppAD::Independent(a_x);
+			set_recording(1, true);
+			reset_op_count<double>();
+			return vec2array(a_x);
+		}
+		AD_AD_double_vec a_x(n);
+		for(size_t j = 0; j < n; j++)
+			a_x[j] = extract<AD_double&>( obj[j] )();
 		CppAD::Independent(a_x);
+		set_recording(2, true);
+		reset_op_count<AD_double>();
 		return vec2array(a_x);
 	}
+	// AD level of the function that adfun(x, y) creates; i.e.,
+	// one (two) if all the elements of x and y are a_float (a2float).
+	int AdfunLevel(object x, object y)
+	{	const char* msg = "adfun(x, y): x or y is not of type numpy.array";
+		array x_array = numpy_vector(msg, x);
+		array y_array = numpy_vector(msg, y);
+		PyArrayObject* px = reinterpret_cast<PyArrayObject*>(x_array.ptr());
+		PyArrayObject* py = reinterpret_cast<PyArrayObject*>(y_array.ptr());
+		msg = "adfun(x, y): elements of x and y are not a_float or a2float";
+		if( PyArray_TYPE(px) != NPY_OBJECT || PyArray_TYPE(py) != NPY_OBJECT )
+			throw not_implemented(msg);
+		if( PyArray_DIMS(px)[0] == 0 )
+			throw not_implemented(msg);
+		object*      obj = static_cast<object*>( PyArray_DATA(px) );
+		element_type t   = element( obj[0].ptr() );
+		if( t != element_a_float && t != element_a2float )
+			throw not_implemented(msg);
+		check_elements("adfun(x, y)", "x", px, t);
+		check_elements("adfun(x, y)", "y", py, t);
+		if( t == element_a_float )
+			return 1;
+		return 2;
+	}
+	// -------------------------------------------------------------
+	// Object array with the same shape as the array p. The elements are
+	// null and must be set using a new reference before it is returned.
+	static object object_array(PyArrayObject* p)
+	{	PyObject* result = PyArray_SimpleNew(
+			PyArray_NDIM(p), PyArray_DIMS(p), NPY_OBJECT
+		);
+		return object( handle<>(result) );
+	}
+	static void set_element(object& a, size_t i, const object& value)
+	{	PyArrayObject* p  = reinterpret_cast<PyArrayObject*>( a.ptr() );
+		PyObject**     pa = static_cast<PyObject**>( PyArray_DATA(p) );
+		Py_XDECREF( pa[i] );
+		pa[i] = boost::python::incref( value.ptr() );
+	}
+	// ad(x) where x is a numpy array with any shape
+	array AdArray(object x)
+	{	array x_array = extract<array>( object( handle<>( 
+			reinterpret_cast<PyObject*>( PyArray_GETCONTIGUOUS(
+				reinterpret_cast<PyArrayObject*>( x.ptr() )
+		) ) ) ) );
+		PyArrayObject* p = reinterpret_cast<PyArrayObject*>( x_array.ptr() );
+		size_t n      = static_cast<size_t>( PyArray_SIZE(p) );
+		object result = object_array(p);
+		void*  data   = PyArray_DATA(p);
+		const char* msg = "ad(x): only implemented where x an int, float, "
+			"a_float or an array of such values.";
+		size_t i;
+		switch( PyArray_TYPE(p) )
+		{	case NPY_DOUBLE:
+			for(i = 0; i < n; i++) set_element(result, i, 
+				object( AD_double( static_cast<double*>(data)[i] ) )
+			);
+			break;
+
+			case NPY_FLOAT:
+			for(i = 0; i < n; i++) set_element(result, i, 
+				object( AD_double( static_cast<float*>(data)[i] ) )
+			);
+			break;
+
+			case NPY_INT:
+			for(i = 0; i < n; i++) set_element(result, i, 
+				object( AD_double( static_cast<int*>(data)[i] ) )
+			);
+			break;
+
+			case NPY_LONG:
+			for(i = 0; i < n; i++) set_element(result, i, object( 
+				AD_double( double( static_cast<long*>(data)[i] ) )
+			) );
+			break;
+
+			case NPY_OBJECT:
+			for(i = 0; i < n; i++)
+			{	object xi = static_cast<object*>(data)[i];
+				switch( element( xi.ptr() ) )
+				{	case element_int:
+					case element_float:
+					set_element(result, i, 
+						object( AD_double( PyFloat_AsDouble(xi.ptr()) ) )
+					);
+					break;
+
+					case element_a_float:
+					set_element(result, i, 
+						object( AD_AD_double( extract<AD_double&>(xi)() ) )
+					);
+					break;
+
+					default:
+					throw not_implemented(msg);
+				}
+			}
+			break;
+
+			default:
+			throw not_implemented(msg);
+		}
+		return extract<array>(result);
+	}
+	// value(a_x) where a_x is a numpy array with any shape
+	array ValueArray(object a_x)
+	{	array a_x_array = extract<array>( object( handle<>( 
+			reinterpret_cast<PyObject*>( PyArray_GETCONTIGUOUS(
+				reinterpret_cast<PyArrayObject*>( a_x.ptr() )
+		) ) ) ) );
+		PyArrayObject* p = reinterpret_cast<PyArrayObject*>(a_x_array.ptr());
+		size_t n = static_cast<size_t>( PyArray_SIZE(p) );
+		const char* msg = "value(a_x): only implemented where a_x is an "
+			"a_float, a2float,\nor an array of a_float or a2float";
+		if( PyArray_TYPE(p) != NPY_OBJECT )
+			throw not_implemented(msg);
+		object* obj = static_cast<object*>( PyArray_DATA(p) );
+		size_t i;
+
+		// check if all the elements are a_float
+		bool all_a_float = true;
+		for(i = 0; i < n; i++)
+		{	element_type t = element( obj[i].ptr() );
+			if( t != element_a_float && t != element_a2float )
+				throw not_implemented(msg);
+			all_a_float &= (t == element_a_float);
+		}
+		if( all_a_float )
+		{	object result( handle<>( PyArray_SimpleNew(
+				PyArray_NDIM(p), PyArray_DIMS(p), NPY_DOUBLE
+			) ) );
+			double* x = static_cast<double*>( PyArray_DATA(
+				reinterpret_cast<PyArrayObject*>( result.ptr() )
+			) );
+			for(i = 0; i < n; i++)
+				x[i] = Value( extract<AD_double&>(obj[i])() );
+			return extract<array>(result);
+		}
+		object result = object_array(p);
+		for(i = 0; i < n; i++)
+		{	if( element( obj[i].ptr() ) == element_a_float )
+				set_element(result, i, 
+					object( Value( extract<AD_double&>(obj[i])() ) )
+				);
+			else	set_element(result, i,
+					object( Value( extract<AD_AD_double&>(obj[i])() ) )
+				);
+		}
+		return extract<array>(result);
+	}
+	// -------------------------------------------------------------
+	// Operand of an array operation; i.e., a contiguous array with double
+	// or object elements made from a numpy array, a list, or a scalar.
+	struct array_operand {
+		object         a;     // reference to the array
+		PyArrayObject* p;     // the array
+		size_t         size;  // number of elements in the array
+		int            level; // highest AD level of the elements
+	};
+	static array_operand make_operand(const char* name, object& x)
+	{	using boost::python::throw_error_already_set;
+		PyObject* q = PyArray_FromAny(
+			x.ptr(), NULL, 0, 0, NPY_ARRAY_CARRAY, NULL
+		);
+		if( q == 0 )
+			throw_error_already_set();
+		if( PyArray_TYPE( reinterpret_cast<PyArrayObject*>(q) ) != NPY_OBJECT )
+		{	PyObject* d = PyArray_FROMANY(
+				q, NPY_DOUBLE, 0, 0, NPY_ARRAY_CARRAY
+			);
+			Py_DECREF(q);
+			if( d == 0 )
+				throw_error_already_set();
+			q = d;
+		}
+		array_operand op;
+		op.a     = object( handle<>(q) );
+		op.p     = reinterpret_cast<PyArrayObject*>(q);
+		op.size  = static_cast<size_t>( PyArray_SIZE(op.p) );
+		op.level = 0;
+		if( PyArray_TYPE(op.p) != NPY_OBJECT )
+			return op;
+		PyObject** e = static_cast<PyObject**>( PyArray_DATA(op.p) );
+		for(size_t i = 0; i < op.size; i++)
+		{	int level = 0;
+			switch( element( e[i] ) )
+			{	case element_int:
+				case element_float:
+				break;
+
+				case element_a_float:
+				level = 1;
+				break;
+
+				case element_a2float:
+				level = 2;
+				break;
+
+				default:
+				{	std::stringstream msg;
+					msg << name << ": element " << i 
+					    << " of an operand has type "
+					    << Py_TYPE( e[i] )->tp_name;
+					throw not_implemented( msg.str().c_str() );
+				}
+			}
+			if( level != 0 && op.level != 0 && level != op.level )
+			{	std::stringstream msg;
+				msg << name << ": mixed a_float and a2float elements";
+				throw not_implemented( msg.str().c_str() );
+			}
+			if( level != 0 )
+				op.level = level;
+		}
+		return op;
+	}
+	// AD level for an operation with the operands op[0], ..., op[n_op-1]
+	static int operand_level(
+		const char* name, const array_operand* op[], size_t n_op)
+	{	std::stringstream msg;
+		msg << name;
+		int level = 0;
+		for(size_t k = 0; k < n_op; k++)
+		{	if( level != 0 && op[k]->level != 0 && op[k]->level != level )
+			{	msg << ": mixed a_float and a2float operands";
+				throw not_implemented( msg.str().c_str() );
+			}
+			if( op[k]->level != 0 )
+				level = op[k]->level;
+		}
+		if( level == 0 )
+		{	msg << ": no element of the operands is an a_float or a2float";
+			throw not_implemented( msg.str().c_str() );
+		}
+		return level;
+	}
+	static int operand_level(
+		const char* name, const array_operand& x, const array_operand& y)
+	{	const array_operand* op[] = { &x, &y };
+		return operand_level(name, op, 2);
+	}
+	// Operand with the shape of the result of an element by element
+	// operation. The operands must have the same shape, except that an
+	// operand with one element is used with every element of the others.
+	static const array_operand& result_shape(
+		const char* name, const array_operand* op[], size_t n_op)
+	{	size_t r = n_op;
+		for(size_t k = 0; k < n_op; k++)
+		{	if( r == n_op && op[k]->size != 1 )
+				r = k;
+		}
+		if( r == n_op )
+		{	r = 0;
+			for(size_t k = 1; k < n_op; k++)
+			{	if( PyArray_NDIM(op[k]->p) > PyArray_NDIM(op[r]->p) )
+					r = k;
+			}
+		}
+		for(size_t k = 0; k < n_op; k++)
+		{	bool same = PyArray_NDIM(op[k]->p) == PyArray_NDIM(op[r]->p);
+			for(int d = 0; same && d < PyArray_NDIM(op[r]->p); d++)
+				same = PyArray_DIMS(op[k]->p)[d] == PyArray_DIMS(op[r]->p)[d];
+			if( ! ( same || op[k]->size == 1 ) )
+			{	std::stringstream msg;
+				msg << name << ": the operands do not have the same shape";
+				throw pycppad::exception( msg.str().c_str() );
+			}
+		}
+		return *op[r];
+	}
+	// i-th element of an operand as an AD<Base> object
+	template <class Base>
+	static CppAD::AD<Base> operand_element(const array_operand& op, size_t i)
+	{	if( PyArray_TYPE(op.p) == NPY_DOUBLE )
+		{	double* x = static_cast<double*>( PyArray_DATA(op.p) );
+			return CppAD::AD<Base>( x[i] );
+		}
+		PyObject* e = static_cast<PyObject**>( PyArray_DATA(op.p) )[i];
+		if( element(e) == element_int || element(e) == element_float )
+			return CppAD::AD<Base>( PyFloat_AsDouble(e) );
+		return extract<const CppAD::AD<Base>&>(e)();
+	}
+	// element by element operations
+	template <class Base>
+	static object array_unary(
+		const array_operand& x                                  ,
+		CppAD::AD<Base> (*fun)(const CppAD::AD<Base>&)          )
+	{	if( PyArray_NDIM(x.p) == 0 )
+			return object( fun( operand_element<Base>(x, 0) ) );
+		object result = object_array(x.p);
+		for(size_t i = 0; i < x.size; i++) set_element(result, i, 
+			object( fun( operand_element<Base>(x, i) ) )
+		);
+		return result;
+	}
+	template <class Base>
+	static object array_binary(
+		const char*          name                               ,
+		const array_operand& x                                  ,
+		const array_operand& y                                  ,
+		CppAD::AD<Base> (*fun)(
+			const CppAD::AD<Base>&, const CppAD::AD<Base>&
+		)                                                       )
+	{	const array_operand* op[]  = { &x, &y };
+		const array_operand& shape = result_shape(name, op, 2);
+		size_t sx = x.size == 1 ? 0 : 1;
+		size_t sy = y.size == 1 ? 0 : 1;
+		if( PyArray_NDIM(shape.p) == 0 ) return object( fun(
+			operand_element<Base>(x, 0), operand_element<Base>(y, 0)
+		) );
+		object result = object_array(shape.p);
+		for(size_t i = 0; i < shape.size; i++) set_element(result, i, 
+			object( fun(
+				operand_element<Base>(x, i * sx) ,
+				operand_element<Base>(y, i * sy)
+			) )
+		);
+		return result;
+	}
+# define PYCPPAD_ARRAY_UNARY(name, fun)                                \
+	object v##name(object x)                                          \
+	{	const char*   n  = "v" #name "(x)";                          \
+		array_operand op = make_operand(n, x);                        \
+		if( operand_level(n, op, op) == 1 )                           \
+			return array_unary(op, op_wrap<double>::fun);            \
+		return array_unary(op, op_wrap<AD_double>::fun);             \
+	}
+	PYCPPAD_ARRAY_UNARY(abs,    abs)
+	PYCPPAD_ARRAY_UNARY(arccos, acos)
+	PYCPPAD_ARRAY_UNARY(arcsin, asin)
+	PYCPPAD_ARRAY_UNARY(arctan, atan)
+	PYCPPAD_ARRAY_UNARY(cos,    cos)
+	PYCPPAD_ARRAY_UNARY(cosh,   cosh)
+	PYCPPAD_ARRAY_UNARY(exp,    exp)
+	PYCPPAD_ARRAY_UNARY(log,    log)
+	PYCPPAD_ARRAY_UNARY(log10,  log10)
+	PYCPPAD_ARRAY_UNARY(sin,    sin)
+	PYCPPAD_ARRAY_UNARY(sinh,   sinh)
+	PYCPPAD_ARRAY_UNARY(sqrt,   sqrt)
+	PYCPPAD_ARRAY_UNARY(tan,    tan)
+	PYCPPAD_ARRAY_UNARY(tanh,   tanh)
+# undef PYCPPAD_ARRAY_UNARY
+# define PYCPPAD_ARRAY_BINARY(name)                                    \
+	object v##name(object x, object y)                                \
+	{	const char*   n   = "v" #name "(x, y)";                      \
+		array_operand opx = make_operand(n, x);                       \
+		array_operand opy = make_operand(n, y);                       \
+		if( operand_level(n, opx, opy) == 1 )                         \
+			return array_binary(n, opx, opy, op_wrap<double>::name); \
+		return array_binary(n, opx, opy, op_wrap<AD_double>::name);  \
+	}
+	PYCPPAD_ARRAY_BINARY(add)
+	PYCPPAD_ARRAY_BINARY(sub)
+	PYCPPAD_ARRAY_BINARY(mul)
+	PYCPPAD_ARRAY_BINARY(div)
+# undef PYCPPAD_ARRAY_BINARY
+	// conditional expressions with array operands
+	template <class Base>
+	static object array_condexp(
+		const char*          name                               ,
+		const array_operand* op[]                               ,
+		CppAD::AD<Base> (*fun)(
+			const CppAD::AD<Base>&, const CppAD::AD<Base>&,
+			const CppAD::AD<Base>&, const CppAD::AD<Base>&
+		)                                                       )
+	{	const array_operand& shape = result_shape(name, op, 4);
+		size_t stride[4];
+		for(size_t k = 0; k < 4; k++)
+			stride[k] = op[k]->size == 1 ? 0 : 1;
+		object result;
+		if( PyArray_NDIM(shape.p) != 0 )
+			result = object_array(shape.p);
+		for(size_t i = 0; i < shape.size; i++)
+		{	object value( fun(
+				operand_element<Base>(*op[0], i * stride[0]) ,
+				operand_element<Base>(*op[1], i * stride[1]) ,
+				operand_element<Base>(*op[2], i * stride[2]) ,
+				operand_element<Base>(*op[3], i * stride[3])
+			) );
+			if( PyArray_NDIM(shape.p) == 0 )
+				return value;
+			set_element(result, i, value);
+		}
+		return result;
+	}
+# define PYCPPAD_ARRAY_CONDEXP(name)                                   \
+	object vcondexp_##name(                                           \
+		object left, object right, object if_true, object if_false)   \
+	{	const char* n = "condexp_" #name                              \
+			"(left, right, if_true, if_false)";                       \
+		array_operand op0 = make_operand(n, left);                    \
+		array_operand op1 = make_operand(n, right);                   \
+		array_operand op2 = make_operand(n, if_true);                 \
+		array_operand op3 = make_operand(n, if_false);                \
+		const array_operand* op[] = { &op0, &op1, &op2, &op3 };       \
+		if( operand_level(n, op, 4) == 1 ) return array_condexp(      \
+			n, op, op_wrap<double>::condexp_##name                    \
+		);                                                            \
+		return array_condexp(n, op, op_wrap<AD_double>::condexp_##name); \
+	}
+	PYCPPAD_ARRAY_CONDEXP(lt)
+	PYCPPAD_ARRAY_CONDEXP(le)
+	PYCPPAD_ARRAY_CONDEXP(eq)
+	PYCPPAD_ARRAY_CONDEXP(ge)
+	PYCPPAD_ARRAY_CONDEXP(gt)
+# undef PYCPPAD_ARRAY_CONDEXP
+	// sum of the elements of x
+	template <class Base>
+	static CppAD::AD<Base> array_sum(const array_operand& x)
+	{	if( x.size == 0 )
+			return CppAD::AD<Base>(0.);
+		CppAD::AD<Base> sum = operand_element<Base>(x, 0);
+		for(size_t i = 1; i < x.size; i++)
+			sum = op_wrap<Base>::add(sum, operand_element<Base>(x, i));
+		return sum;
+	}
+	object vsum(object x)
+	{	const char*   n  = "vsum(x)";
+		array_operand op = make_operand(n, x);
+		if( operand_level(n, op, op) == 1 )
+			return object( array_sum<double>(op) );
+		return object( array_sum<AD_double>(op) );
+	}
+	// sum of a[offset + j] * b[j] for j = 0, ..., b.size-1
+	// (products with a constant zero are not recorded)
+	template <class Base>
+	static CppAD::AD<Base> array_dot(
+		const array_operand& a, size_t offset, const array_operand& b)
+	{	typedef CppAD::AD<Base> AD;
+		AD   sum   = AD(0.);
+		bool first = true;
+		for(size_t j = 0; j < b.size; j++)
+		{	AD aj = operand_element<Base>(a, offset + j);
+			AD bj = operand_element<Base>(b, j);
+			if( CppAD::IdenticalZero(aj) || CppAD::IdenticalZero(bj) )
+				continue;
+			AD term = op_wrap<Base>::mul(aj, bj);
+			if( first )
+				sum = term;
+			else	sum = op_wrap<Base>::add(sum, term);
+			first = false;
+		}
+		return sum;
+	}
+	template <class Base>
+	static object array_dot(const array_operand& a, const array_operand& b)
+	{	if( PyArray_NDIM(a.p) == 1 )
+			return object( array_dot<Base>(a, 0, b) );
+		npy_intp m = PyArray_DIMS(a.p)[0];
+		object result( handle<>( PyArray_SimpleNew(1, &m, NPY_OBJECT) ) );
+		for(size_t i = 0; i < size_t(m); i++) set_element(result, i, 
+			object( array_dot<Base>(a, i * b.size, b) )
+		);
+		return result;
+	}
+	object vdot(object a, object b)
+	{	const char*   n   = "vdot(a, b)";
+		array_operand opa = make_operand(n, a);
+		array_operand opb = make_operand(n, b);
+		int nd = PyArray_NDIM(opa.p);
+		PYCPPAD_ASSERT(
+			(nd == 1 || nd == 2) && PyArray_NDIM(opb.p) == 1 &&
+			size_t( PyArray_DIMS(opa.p)[nd-1] ) == opb.size,
+			"vdot(a, b): a is not a vector or matrix with as many "
+			"columns as b has elements"
+		);
+		if( operand_level(n, opa, opb) == 1 )
+			return array_dot<double>(opa, opb);
+		return array_dot<AD_double>(opa, opb);
+	}
+	// -------------------------------------------------------------
+	// Dense linear algebra recorded as one atomic operation; see atomic.hpp
+	template <class Base>
+	static void atomic_argument(
+		const array_operand&                op     ,
+		CppAD::vector< CppAD::AD<Base> >&   ax     ,
+		size_t                              offset )
+	{	for(size_t i = 0; i < op.size; i++)
+			ax[offset + i] = operand_element<Base>(op, i);
+	}
+	// count the atomic operation and return its result with shape dims
+	template <class Base>
+	static object atomic_result(
+		const CppAD::vector< CppAD::AD<Base> >& ax   ,
+		const CppAD::vector< CppAD::AD<Base> >& ay   ,
+		const std::vector<npy_intp>&            dims )
+	{	bool variable = false;
+		for(size_t i = 0; i < ax.size(); i++)
+			variable |= CppAD::Variable( ax[i] );
+		count_op<Base>(op_atomic, variable);
+		if( dims.size() == 0 )
+			return object( ay[0] );
+		npy_intp shape[2];
+		for(size_t k = 0; k < dims.size(); k++)
+			shape[k] = dims[k];
+		object result( handle<>( PyArray_SimpleNew(
+			int( dims.size() ), shape, NPY_OBJECT
+		) ) );
+		for(size_t i = 0; i < ay.size(); i++)
+			set_element(result, i, object( ay[i] ) );
+		return result;
+	}
+	template <class Base>
+	static object atomic_matmul_call(
+		const array_operand& a, const array_operand& b,
+		size_t m, size_t k, size_t n, const std::vector<npy_intp>& dims)
+	{	CppAD::vector< CppAD::AD<Base> > ax(m * k + k * n), ay(m * n);
+		atomic_argument(a, ax, 0);
+		atomic_argument(b, ax, m * k);
+		matmul_atomic<Base>(m, k, n)(ax, ay);
+		return atomic_result(ax, ay, dims);
+	}
+	template <class Base>
+	static object atomic_solve_call(
+		const array_operand& a, const array_operand& b,
+		size_t n, size_t m, bool cholesky, const std::vector<npy_intp>& dims)
+	{	CppAD::vector< CppAD::AD<Base> > ax(n * n + n * m), ay(n * m);
+		atomic_argument(a, ax, 0);
+		atomic_argument(b, ax, n * n);
+		solve_atomic<Base>(n, m, cholesky)(ax, ay);
+		return atomic_result(ax, ay, dims);
+	}
+	object Matmul(object a, object b)
+	{	const char*   name = "matmul(a, b)";
+		array_operand opa  = make_operand(name, a);
+		array_operand opb  = make_operand(name, b);
+		int nda = PyArray_NDIM(opa.p);
+		int ndb = PyArray_NDIM(opb.p);
+		PYCPPAD_ASSERT(
+			(nda == 1 || nda == 2) && (ndb == 1 || ndb == 2) ,
+			"matmul(a, b): a or b is not a vector or matrix"
+		);
+		size_t m  = nda == 2 ? size_t( PyArray_DIMS(opa.p)[0] ) : 1;
+		size_t k  = size_t( PyArray_DIMS(opa.p)[nda - 1] );
+		size_t kb = size_t( PyArray_DIMS(opb.p)[0] );
+		size_t n  = ndb == 2 ? size_t( PyArray_DIMS(opb.p)[1] ) : 1;
+		PYCPPAD_ASSERT(
+			k == kb && m * k * n > 0 ,
+			"matmul(a, b): the number of columns in a is not equal to the "
+			"number of rows in b, or an operand is empty"
+		);
+		std::vector<npy_intp> dims;
+		if( nda == 2 )
+			dims.push_back( npy_intp(m) );
+		if( ndb == 2 )
+			dims.push_back( npy_intp(n) );
+		if( operand_level(name, opa, opb) == 1 )
+			return atomic_matmul_call<double>(opa, opb, m, k, n, dims);
+		return atomic_matmul_call<AD_double>(opa, opb, m, k, n, dims);
+	}
+	static object atomic_solve_py(
+		const char* name, object& a, object& b, bool cholesky)
+	{	array_operand opa  = make_operand(name, a);
+		array_operand opb  = make_operand(name, b);
+		int nda = PyArray_NDIM(opa.p);
+		int ndb = PyArray_NDIM(opb.p);
+		PYCPPAD_ASSERT(
+			nda == 2 && (ndb == 1 || ndb == 2) ,
+			"lu_solve or cholesky_solve(a, b): "
+			"a is not a matrix or b is not a vector or matrix"
+		);
+		size_t n  = size_t( PyArray_DIMS(opa.p)[0] );
+		size_t na = size_t( PyArray_DIMS(opa.p)[1] );
+		size_t nb = size_t( PyArray_DIMS(opb.p)[0] );
+		size_t m  = ndb == 2 ? size_t( PyArray_DIMS(opb.p)[1] ) : 1;
+		PYCPPAD_ASSERT(
+			n == na && n == nb && n * m > 0 ,
+			"lu_solve or cholesky_solve(a, b): a is not square, "
+			"b does not have as many rows as a, or an operand is empty"
+		);
+		std::vector<npy_intp> dims;
+		dims.push_back( npy_intp(n) );
+		if( ndb == 2 )
+			dims.push_back( npy_intp(m) );
+		if( operand_level(name, opa, opb) == 1 )
+			return atomic_solve_call<double>(opa, opb, n, m, cholesky, dims);
+		return atomic_solve_call<AD_double>(opa, opb, n, m, cholesky, dims);
+	}
+	object LuSolve(object a, object b)
+	{	return atomic_solve_py("lu_solve(a, b)", a, b, false); }
+	object CholeskySolve(object a, object b)
+	{	return atomic_solve_py("cholesky_solve(a, b)", a, b, true); }
+	// reductions over all the elements of the operands, recorded as one
+	// atomic operation (a dot product is a one by n times n by one matmul)
+	//
+	// value of element i of a level zero operand
+	static double float_element(const array_operand& op, size_t i)
+	{	if( PyArray_TYPE(op.p) == NPY_DOUBLE )
+			return static_cast<double*>( PyArray_DATA(op.p) )[i];
+		return PyFloat_AsDouble(
+			static_cast<PyObject**>( PyArray_DATA(op.p) )[i]
+		);
+	}
+	// reduction of level zero operands (nothing is recorded)
+	static object float_reduce(
+		const array_operand& x, const array_operand& y, bool product)
+	{	double sum = 0.;
+		for(size_t i = 0; i < x.size; i++)
+		{	if( product )
+				sum += float_element(x, i) * float_element(y, i);
+			else	sum += float_element(x, i);
+		}
+		return object(sum);
+	}
+	template <class Base>
+	static object atomic_sum_call(const array_operand& x, bool square)
+	{	std::vector<npy_intp> dims;
+		if( x.size == 0 )
+			return object( CppAD::AD<Base>(0.) );
+		CppAD::vector< CppAD::AD<Base> > ax(x.size), ay(1);
+		atomic_argument(x, ax, 0);
+		sum_atomic<Base>(x.size, square)(ax, ay);
+		return atomic_result(ax, ay, dims);
+	}
+	object ReduceSum(object x)
+	{	const char*   name = "reduce_sum(x)";
+		array_operand op   = make_operand(name, x);
+		if( op.level == 0 )
+			return float_reduce(op, op, false);
+		if( operand_level(name, op, op) == 1 )
+			return atomic_sum_call<double>(op, false);
+		return atomic_sum_call<AD_double>(op, false);
+	}
+	object ReduceSumsq(object x)
+	{	const char*   name = "reduce_sumsq(x)";
+		array_operand op   = make_operand(name, x);
+		if( op.level == 0 )
+			return float_reduce(op, op, true);
+		if( operand_level(name, op, op) == 1 )
+			return atomic_sum_call<double>(op, true);
+		return atomic_sum_call<AD_double>(op, true);
+	}
+	object ReduceDot(object x, object y)
+	{	const char*   name = "reduce_dot(x, y)";
+		array_operand opx  = make_operand(name, x);
+		array_operand opy  = make_operand(name, y);
+		PYCPPAD_ASSERT(
+			opx.size == opy.size,
+			"reduce_dot(x, y): x and y have a different number of elements"
+		);
+		if( opx.level == 0 && opy.level == 0 )
+			return float_reduce(opx, opy, true);
+		std::vector<npy_intp> dims;
+		size_t n = opx.size;
+		if( operand_level(name, opx, opy) == 1 )
+		{	if( n == 0 )
+				return object( AD_double(0.) );
+			return atomic_matmul_call<double>(opx, opy, 1, n, 1, dims);
+		}
+		if( n == 0 )
+			return object( AD_AD_double(0.) );
+		return atomic_matmul_call<AD_double>(opx, opy, 1, n, 1, dims);
+	}
 	// -------------------------------------------------------------
 	double double_(const AD_double& x)
 	{	return Value(x); }
@@ -654,6 +1710,8 @@ namespace pycppad {
 	void abort_recording(void)
 	{	AD_double::abort_recording();
 		AD_AD_double::abort_recording();
+		set_recording(1, false);
+		set_recording(2, false);
 		return;
 	}
 }
@@ -663,18 +1721,13 @@ BOOST_PYTHON_MODULE(cppad_)
 	// when the throw in cppad_error_handler occurs
 	boost::python::register_exception_translator<pycppad::exception>
 		(&pycppad::translate_exception); 
+	boost::python::register_exception_translator<pycppad::not_implemented>
+		(&pycppad::translate_not_implemented); 
 
 	// AD_double is used in pycppad namespace
 	typedef CppAD::AD<double>    AD_double;
 	typedef CppAD::AD<AD_double> AD_AD_double;
 
-	// standard math functions
-	PYCPPAD_STD_MATH_LINK_CPP(double);
-	PYCPPAD_STD_MATH_LINK_CPP(AD_double);
-	// conditional expressions
-	PYCPPAD_COND_EXP_LINK_CPP(double);
-	PYCPPAD_COND_EXP_LINK_CPP(AD_double);
-
 	// here are the things we are using from boost::python
 	using boost::python::numeric::array;
 	using boost::python::class_;
@@ -682,8 +1735,7 @@ BOOST_PYTHON_MODULE(cppad_)
 	using boost::python::self;
 	using boost::python::self_ns::str;
 	using boost::python::def;
-    using boost::python::manage_new_object;
-    using boost::python::return_value_policy;
+    using boost::python::return_self;
 
 	using pycppad::ADFun_double;
 	using pycppad::ADFun_AD_double;
@@ -694,67 +1746,152 @@ BOOST_PYTHON_MODULE(cppad_)
 	array::set_module_and_type("numpy", "ndarray");
 	// --------------------------------------------------------------------
 	def("independent", pycppad::Independent);
+	def("adfun_level_", pycppad::AdfunLevel);
+	def("ad_",          pycppad::AdArray);
+	def("value_",       pycppad::ValueArray);
+	// array operations
+	def("vabs",      pycppad::vabs);
+	def("varccos",   pycppad::varccos);
+	def("varcsin",   pycppad::varcsin);
+	def("varctan",   pycppad::varctan);
+	def("vcos",      pycppad::vcos);
+	def("vcosh",     pycppad::vcosh);
+	def("vexp",      pycppad::vexp);
+	def("vlog",      pycppad::vlog);
+	def("vlog10",    pycppad::vlog10);
+	def("vsin",      pycppad::vsin);
+	def("vsinh",     pycppad::vsinh);
+	def("vsqrt",     pycppad::vsqrt);
+	def("vtan",      pycppad::vtan);
+	def("vtanh",     pycppad::vtanh);
+	def("vadd",      pycppad::vadd);
+	def("vsub",      pycppad::vsub);
+	def("vmul",      pycppad::vmul);
+	def("vdiv",      pycppad::vdiv);
+	def("vsum",      pycppad::vsum);
+	def("vdot",      pycppad::vdot);
+	def("matmul",         pycppad::Matmul);
+	def("lu_solve",       pycppad::LuSolve);
+	def("cholesky_solve", pycppad::CholeskySolve);
+	def("reduce_sum",     pycppad::ReduceSum);
+	def("reduce_sumsq",   pycppad::ReduceSumsq);
+	def("reduce_dot",     pycppad::ReduceDot);
 	def("float_",     pycppad::double_);
 	def("a_float_",   pycppad::AD_double_);
 	// documented in adfun.py
 	def("abort_recording", pycppad::abort_recording);
-	// conditional expressions
+	// documented in adfun.py
+	def("recording_threads", pycppad::recording_threads);
+	// documented in adfun.cpp
+	def("counters",        pycppad::global_counters_dict);
+	def("reset_counters",  pycppad::reset_global_counters);
+	def("record_label",    pycppad::record_label);
+	def("memory",            pycppad::memory_dict);
+	def("release_memory",    pycppad::release_memory);
+	def("reset_peak_memory", pycppad::reset_peak_memory);
+	def("hold_memory",       pycppad::hold_memory);
+	// conditional expressions (the array versions are registered first so
+	// that boost-python tries them last)
+	def("condexp_lt", pycppad::vcondexp_lt);
+	def("condexp_le", pycppad::vcondexp_le);
+	def("condexp_eq", pycppad::vcondexp_eq);
+	def("condexp_ge", pycppad::vcondexp_ge);
+	def("condexp_gt", pycppad::vcondexp_gt);
 	PYCPPAD_COND_EXP_LINK_PY(double)
 	PYCPPAD_COND_EXP_LINK_PY(AD_double)
 	// --------------------------------------------------------------------
 	class_<AD_double>("a_float", init<double>())
 		.def(str(self))
-		PYCPPAD_OPERATOR_LIST
+		PYCPPAD_OPERATOR_LIST(double)
 		PYCPPAD_STD_MATH_LINK_PY(double)
 
 		// abs
-		.def( abs(self) )
+		.def("__abs__", pycppad::op_wrap<double>::abs)
 
 		// pow
-     	.def( pow(self, self) ) 
-     	.def( pow(self, double()) )
-     	.def( pow(self, int()) )
-     	.def( pow(double(), self) )
+		.def("__pow__",  pycppad::op_wrap<double>::pow)
+		.def("__pow__",  pycppad::op_wrap<double>::pow_d)
+		.def("__pow__",  pycppad::op_wrap<double>::pow_i)
+		.def("__rpow__", pycppad::op_wrap<double>::rpow_d)
 
         // truediv (returns python 3 division even when in python 2)
-        .def("__truediv__", truediv1, return_value_policy<manage_new_object>())
-        .def("__truediv__", truediv2, return_value_policy<manage_new_object>())
-        .def("__rtruediv__", truediv3, return_value_policy<manage_new_object>())
+        .def("__truediv__", truediv1)
+        .def("__truediv__", truediv2)
+        .def("__rtruediv__", truediv3)
 
 	;
 
 	class_<ADFun_double>("adfun_float", init< array& , array& >())
 		.def("domain",    &ADFun_double::Domain)
 		.def("forward",   &ADFun_double::Forward)
+		.def("forward_points", &ADFun_double::ForwardPoints)
 		.def("compare_change",   &ADFun_double::CompareChange)
-		.def("hessian_" , &ADFun_double::Hessian)
-		.def("jacobian_", &ADFun_double::Jacobian)
-		.def("optimize",  &ADFun_double::optimize)
+		.def("hessian" ,  &ADFun_double::Hessian)
+		.def("hessian_vector", &ADFun_double::HessianVector)
+		.def("hessian_diagonal", &ADFun_double::HessianDiagonal)
+		.def("jacobian",  &ADFun_double::Jacobian)
+		.def("optimize_", &ADFun_double::optimize)
+		.def("derivative_", &ADFun_double::Derivative)
 		.def("range",     &ADFun_double::Range)
 		.def("reverse",   &ADFun_double::Reverse)
+		.def("value_and_grad", &ADFun_double::ValueAndGrad)
+		.def("value_jac_hess", &ADFun_double::ValueJacHess)
+		.def("jac_vec_",       &ADFun_double::JacVec)
+		.def("vec_jac_",       &ADFun_double::VecJac)
+		.def("taylor_id_",     &ADFun_double::TaylorId)
+		.def("stats",          &ADFun_double::Stats)
+		.def("counters",       &ADFun_double::Counters)
+		.def("reset_counters", &ADFun_double::ResetCounters)
+		.def("profile",        &ADFun_double::Profile)
+		.def("profile_data_",  &ADFun_double::ProfileData)
+		.def("memory",         &ADFun_double::Memory)
+		.def("capacity_order", &ADFun_double::CapacityOrder)
+		.def("capacity_policy",&ADFun_double::CapacityPolicy)
 	;
 	// --------------------------------------------------------------------
 	class_<AD_AD_double>("a2float", init<AD_double>())
 		.def(str(self))
-		PYCPPAD_OPERATOR_LIST
+		PYCPPAD_OPERATOR_LIST(AD_double)
 		PYCPPAD_STD_MATH_LINK_PY(AD_double)
 
 		// abs
-		.def( abs(self) )
+		.def("__abs__", pycppad::op_wrap<AD_double>::abs)
 
 		// pow
-     	.def( pow(self, self) ) 
-     	.def( pow(self, double()) )
-     	.def( pow(double(), self) )
+		.def("__pow__",  pycppad::op_wrap<AD_double>::pow)
+		.def("__pow__",  pycppad::op_wrap<AD_double>::pow_d)
+		.def("__rpow__", pycppad::op_wrap<AD_double>::rpow_d)
 	;
 	class_<ADFun_AD_double>("adfun_a_float", init< array& , array& >())
 		.def("domain",    &ADFun_AD_double::Domain)
 		.def("range",     &ADFun_AD_double::Range)
 		.def("forward",   &ADFun_AD_double::Forward)
+		.def("forward_points", &ADFun_AD_double::ForwardPoints)
 		.def("compare_change",   &ADFun_AD_double::CompareChange)
 		.def("reverse",   &ADFun_AD_double::Reverse)
-		.def("jacobian_", &ADFun_AD_double::Jacobian)
-		.def("hessian_",  &ADFun_AD_double::Hessian)
+		.def("jacobian",  &ADFun_AD_double::Jacobian)
+		.def("hessian",   &ADFun_AD_double::Hessian)
+		.def("optimize_", &ADFun_AD_double::optimize)
+		.def("derivative_", &ADFun_AD_double::Derivative)
+		.def("hessian_vector", &ADFun_AD_double::HessianVector)
+		.def("hessian_diagonal", &ADFun_AD_double::HessianDiagonal)
+		.def("value_and_grad", &ADFun_AD_double::ValueAndGrad)
+		.def("value_jac_hess", &ADFun_AD_double::ValueJacHess)
+		.def("jac_vec_",       &ADFun_AD_double::JacVec)
+		.def("vec_jac_",       &ADFun_AD_double::VecJac)
+		.def("taylor_id_",     &ADFun_AD_double::TaylorId)
+		.def("stats",          &ADFun_AD_double::Stats)
+		.def("counters",       &ADFun_AD_double::Counters)
+		.def("reset_counters", &ADFun_AD_double::ResetCounters)
+		.def("profile",        &ADFun_AD_double::Profile)
+		.def("profile_data_",  &ADFun_AD_double::ProfileData)
+		.def("memory",         &ADFun_AD_double::Memory)
+		.def("capacity_order", &ADFun_AD_double::CapacityOrder)
+		.def("capacity_policy",&ADFun_AD_double::CapacityPolicy)
 	;
+	// --------------------------------------------------------------------
+	// reuse the python instances of a_float and a2float (see freelist.hpp)
+	pycppad::install_freelist<AD_double>();
+	pycppad::install_freelist<AD_AD_double>();
 }
 
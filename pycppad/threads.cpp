@@ -0,0 +1,96 @@
+# include "threads.hpp"
+# include <pythread.h>
+
+namespace pycppad {
+	namespace {
+		// number of CppAD thread numbers (one until recording_threads)
+		size_t        n_thread_ = 1;
+		// python thread that owns each thread number (if owned_ is true)
+		bool          owned_[CPPAD_MAX_NUM_THREADS];
+		unsigned long owner_[CPPAD_MAX_NUM_THREADS];
+		// recording_[t][level-1] is true while level records in thread t
+		bool          recording_[CPPAD_MAX_NUM_THREADS][2];
+
+		unsigned long current_thread(void)
+		{	return static_cast<unsigned long>(
+				PyThread_get_thread_ident()
+			);
+		}
+		bool is_recording(size_t t)
+		{	return recording_[t][0] || recording_[t][1]; }
+		bool in_parallel(void)
+		{	return false; }
+	}
+
+	size_t thread_number(void)
+	{	if( n_thread_ == 1 )
+			return 0;
+		unsigned long ident = current_thread();
+		for(size_t t = 1; t < n_thread_; t++)
+		{	if( owned_[t] && owner_[t] == ident )
+				return t;
+		}
+		return 0;
+	}
+
+	void claim_thread_number(void)
+	{	if( n_thread_ == 1 || thread_number() != 0 )
+			return;
+		// prefer a number that is not owned to one that is not recording
+		// (a number stays owned if CppAD::Independent failed)
+		size_t t = 1;
+		while( t < n_thread_ && owned_[t] )
+			t++;
+		if( t == n_thread_ )
+		{	t = 1;
+			while( t < n_thread_ && is_recording(t) )
+				t++;
+		}
+		if( t == n_thread_ ) throw pycppad::exception(
+			"independent: all of the recording_threads are recording"
+		);
+		owned_[t] = true;
+		owner_[t] = current_thread();
+	}
+
+	void set_recording(size_t level, bool recording)
+	{	size_t t = thread_number();
+		recording_[t][level - 1] = recording;
+		// release the thread number when its recordings are done
+		if( t != 0 && ! is_recording(t) )
+			owned_[t] = false;
+	}
+
+	void recording_threads(int n)
+	{	using CppAD::thread_alloc;
+		PYCPPAD_ASSERT( n >= 1,
+			"recording_threads(n): n is less than one"
+		);
+		PYCPPAD_ASSERT( size_t(n) < CPPAD_MAX_NUM_THREADS,
+			"recording_threads(n): n + 1 is greater than the "
+			"CppAD maximum number of threads"
+		);
+		for(size_t t = 0; t < n_thread_; t++)
+		{	PYCPPAD_ASSERT( ! is_recording(t),
+				"recording_threads(n): a recording is in progress"
+			);
+		}
+		for(size_t t = 0; t < CPPAD_MAX_NUM_THREADS; t++)
+			owned_[t] = false;
+		// memory held for the current thread numbers (other than zero)
+		for(size_t t = 1; t < n_thread_; t++)
+			thread_alloc::free_available(t);
+		if( n == 1 )
+		{	thread_alloc::parallel_setup(1, 0, 0);
+			n_thread_ = 1;
+		}
+		else
+		{	n_thread_ = size_t(n) + 1;
+			thread_alloc::parallel_setup(
+				n_thread_, in_parallel, thread_number
+			);
+		}
+		CppAD::parallel_ad<double>();
+		CppAD::parallel_ad<AD_double>();
+	}
+}
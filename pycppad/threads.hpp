@@ -0,0 +1,40 @@
+# ifndef PYCPPAD_THREADS_INCLUDED
+# define PYCPPAD_THREADS_INCLUDED
+
+# include "environment.hpp"
+
+/*
+CppAD keeps one recording for each AD<Base> type and CppAD thread number.
+After recording_threads(n) with n > 1, a python thread that calls
+independent gets its own CppAD thread number (one through n) and keeps it
+until its recordings end (adfun or abort_recording).
+All the other python threads use thread number zero. Every call to CppAD
+is made holding the python global interpreter lock, so CppAD is never
+told that it is in parallel mode.
+*/
+namespace pycppad {
+	// python function: number of threads that can record at the same time
+	void recording_threads(int n);
+
+	// CppAD thread number for the current python thread
+	size_t thread_number(void);
+
+	// give the current python thread a thread number for a new recording
+	// (called by independent before CppAD::Independent)
+	void claim_thread_number(void);
+
+	// a recording of AD level one or two starts (or stops) in this thread
+	void set_recording(size_t level, bool recording);
+
+	// AD level of a recording that uses AD<Base>
+	template <class Base>
+	size_t recording_level(void);
+	template <>
+	inline size_t recording_level<double>(void)
+	{	return 1; }
+	template <>
+	inline size_t recording_level<AD_double>(void)
+	{	return 2; }
+}
+
+# endif
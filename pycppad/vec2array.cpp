@@ -1,15 +1,31 @@
 # include "vec2array.hpp"
+# include "instrument.hpp"
 
 # define PY_ARRAY_UNIQUE_SYMBOL PyArray_Pycppad
 
 # define PYCPPAD_DEBUG_ISSUES
 
 namespace pycppad {
+// Store the elements of vec in the object array obj directly
+// (instead of one python __setitem__ call per element).
+// The elements of obj are null when it is created by PyArray_SimpleNew.
+template <class Vector>
+static void set_objects(object& obj, Vector& vec)
+{	PyObject** ptr = static_cast<PyObject**> ( PyArray_DATA (
+		reinterpret_cast<PyArrayObject*> ( obj.ptr() )
+	));
+	for(size_t i = 0; i < vec.size(); i++)
+	{	object element( vec[i] );
+		Py_XDECREF( ptr[i] );
+		ptr[i] = boost::python::incref( element.ptr() );
+	}
+}
 array vec2array(double_vec& vec)
 {	npy_intp n = static_cast<npy_intp>( vec.size() );
 	PYCPPAD_ASSERT( n >= 0 , "");
 
 	object obj(handle<>( PyArray_SimpleNew(1, &n, NPY_DOUBLE) ));
+	PYCPPAD_PROBE_BYTES( vec.size() * sizeof(double) );
 	double *ptr = static_cast<double*> ( PyArray_DATA (
 		reinterpret_cast<PyArrayObject*> ( obj.ptr() )
 	));
@@ -24,9 +40,8 @@ array vec2array(AD_double_vec& vec)
 	PYCPPAD_ASSERT( n >= 0 , "");
 
 	object obj(handle<>( PyArray_SimpleNew(1, &n, NPY_OBJECT) ));
-	for(size_t i = 0; i < vec.size(); i++){
-		obj[i] = vec[i];
-	}
+	PYCPPAD_PROBE_BYTES( vec.size() * sizeof(PyObject*) );
+	set_objects(obj, vec);
 	return  static_cast<array>( obj );
 }
 array vec2array(AD_AD_double_vec& vec)
@@ -34,11 +49,26 @@ array vec2array(AD_AD_double_vec& vec)
 	PYCPPAD_ASSERT( n >= 0 , "");
 
 	object obj(handle<>( PyArray_SimpleNew(1, &n, NPY_OBJECT) ));
-	for(size_t i = 0; i < vec.size(); i++){
-		obj[i] = vec[i];
-	}
+	PYCPPAD_PROBE_BYTES( vec.size() * sizeof(PyObject*) );
+	set_objects(obj, vec);
 	return  static_cast<array>( obj );
 }
+// ------------------------------------------------------------------------
+// matrix versions: set the shape in place so no copy of the data is made
+template <class Vector>
+static array vec2matrix(size_t nr, size_t nc, Vector& vec)
+{	PYCPPAD_ASSERT( nr * nc == vec.size() , "");
+
+	array result = vec2array(vec);
+	result.attr("shape") = boost::python::make_tuple(nr, nc);
+	return result;
+}
+array vec2array(size_t nr, size_t nc, double_vec& vec)
+{	return vec2matrix(nr, nc, vec); }
+array vec2array(size_t nr, size_t nc, AD_double_vec& vec)
+{	return vec2matrix(nr, nc, vec); }
+array vec2array(size_t nr, size_t nc, AD_AD_double_vec& vec)
+{	return vec2matrix(nr, nc, vec); }
 // ========================================================================
 void vec2array_import_array(void)
 {	import_array(); }
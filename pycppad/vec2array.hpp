@@ -9,6 +9,11 @@ namespace pycppad {
 	array vec2array(AD_double_vec& vec);
 	array vec2array(AD_AD_double_vec& vec);
 
+	// matrix versions (vec is in row major order)
+	array vec2array(size_t nr, size_t nc, double_vec& vec);
+	array vec2array(size_t nr, size_t nc, AD_double_vec& vec);
+	array vec2array(size_t nr, size_t nc, AD_AD_double_vec& vec);
+
 	// some kind of hack connected to numeric::array
 	void vec2array_import_array(void);
 }
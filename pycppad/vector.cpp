@@ -1,4 +1,5 @@
 # include "vector.hpp"
+# include "memory.hpp"
 
 namespace pycppad {
 // ========================================================================
@@ -29,8 +30,17 @@ vec<double>::vec(array& boost_array)
 		);
 		allocated_ = false;
 	}
+	else if( PyArray_TYPE(py_array_p) == NPY_FLOAT )
+	{	pointer_   = new_scratch<double>(length_);
+		float* data = 	static_cast<float*>( 
+			PyArray_DATA(py_array_p)
+		);
+		for(size_t i = 0; i < length_; i++)
+			pointer_[i] = static_cast<double>( data[i] );
+		allocated_ = true;
+	}
 	else if( PyArray_TYPE(py_array_p) == NPY_INT )
-	{	pointer_   = CPPAD_TRACK_NEW_VEC(length, pointer_);
+	{	pointer_   = new_scratch<double>(length_);
 		int* data = 	static_cast<int*>( 
 			PyArray_DATA(py_array_p)
 		);
@@ -39,7 +49,7 @@ vec<double>::vec(array& boost_array)
 		allocated_ = true;
 	}
 	else if( PyArray_TYPE(py_array_p) == NPY_LONG )
-	{	pointer_   = CPPAD_TRACK_NEW_VEC(length, pointer_);
+	{	pointer_   = new_scratch<double>(length_);
 		long* data = 	static_cast<long*>( 
 			PyArray_DATA(py_array_p)
 		);
@@ -49,7 +59,7 @@ vec<double>::vec(array& boost_array)
 	}
 	else	PYCPPAD_ASSERT(
 		0,
-		"expected an array with int or float elements"
+		"expected an array with int, float or float32 elements"
 	);
 	return;
 }
@@ -58,7 +68,7 @@ vec<double>::vec(array& boost_array)
 vec<double>::vec(size_t length)
 {	// set private data
 	length_    = length;
-	pointer_   = CPPAD_TRACK_NEW_VEC(length, pointer_);
+	pointer_   = new_scratch<double>(length);
 	allocated_ = true;
 	return;
 }
@@ -66,7 +76,7 @@ vec<double>::vec(size_t length)
 // copy constructor
 vec<double>::vec(const vec& v)
 {	length_    = v.length_;
-	pointer_   = CPPAD_TRACK_NEW_VEC(length_, pointer_);
+	pointer_   = new_scratch<double>(length_);
 	allocated_ = true;
 	for(size_t i = 0; i < length_; i++)
 		pointer_[i] = v[i];
@@ -82,7 +92,7 @@ vec<double>::vec(void)
 // destructor
 vec<double>::~vec(void)
 {	if( allocated_ )
-		CPPAD_TRACK_DEL_VEC(pointer_);	
+		delete_scratch(pointer_, length_);
 }
 
 // assignment operator
@@ -100,8 +110,8 @@ size_t vec<double>::size(void) const
 // resize 
 void vec<double>::resize(size_t length)
 {	if( allocated_ )
-		CPPAD_TRACK_DEL_VEC(pointer_);
-	pointer_   = CPPAD_TRACK_NEW_VEC(length, pointer_);
+		delete_scratch(pointer_, length_);
+	pointer_   = new_scratch<double>(length);
 	length_    = length;
 	allocated_ = true;
 }
@@ -150,7 +160,7 @@ vec<Scalar>::vec(array& boost_array)
 	// set private data
 	length_  = static_cast<size_t>(length);
 	pointer_ = 0;
-	handle_  = CPPAD_TRACK_NEW_VEC(length_, handle_);
+	handle_  = new_scratch<Scalar*>(length_);
 	for(size_t i = 0; i < length_; i++) handle_[i] = 
 		& extract<Scalar&>(obj_ptr[i])(); 
 	return;
@@ -160,8 +170,8 @@ template <class Scalar>
 vec<Scalar>::vec(size_t length)
 {
 	length_  = length;
-	pointer_ = CPPAD_TRACK_NEW_VEC(length, pointer_);
-	handle_  = CPPAD_TRACK_NEW_VEC(length, handle_);
+	pointer_ = new_scratch<Scalar>(length);
+	handle_  = new_scratch<Scalar*>(length);
 	for(size_t i = 0; i < length_; i++)
 		handle_[i] = pointer_ + i;
 	return;
@@ -172,8 +182,8 @@ template <class Scalar>
 vec<Scalar>::vec(const vec& v)
 {
 	length_   = v.length_;
-	pointer_  = CPPAD_TRACK_NEW_VEC(length_, pointer_);
-	handle_   = CPPAD_TRACK_NEW_VEC(length_, handle_);
+	pointer_  = new_scratch<Scalar>(length_);
+	handle_   = new_scratch<Scalar*>(length_);
 	for(size_t i = 0; i < length_; i++)
 	{	handle_[i]  = pointer_ + i;
 		pointer_[i] = v[i];
@@ -194,9 +204,9 @@ template <class Scalar>
 vec<Scalar>::~vec(void)
 {
 	if( handle_ != 0 )
-		CPPAD_TRACK_DEL_VEC(handle_); 
+		delete_scratch(handle_, length_);
 	if( pointer_ != 0 )
-		CPPAD_TRACK_DEL_VEC(pointer_);	
+		delete_scratch(pointer_, length_);
 }
 
 // assignment operator
@@ -219,11 +229,11 @@ template <class Scalar>
 void vec<Scalar>::resize(size_t length)
 {
 	if( handle_ != 0 )
-		CPPAD_TRACK_DEL_VEC(handle_);
+		delete_scratch(handle_, length_);
 	if( pointer_ != 0 )
-		CPPAD_TRACK_DEL_VEC(pointer_);
-	pointer_   = CPPAD_TRACK_NEW_VEC(length, pointer_);
-	handle_    = CPPAD_TRACK_NEW_VEC(length, handle_);
+		delete_scratch(pointer_, length_);
+	pointer_   = new_scratch<Scalar>(length);
+	handle_    = new_scratch<Scalar*>(length);
 	length_    = length;
 	for(size_t i = 0; i < length_; i++)
 		handle_[i]  = pointer_ + i;
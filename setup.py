@@ -20,6 +20,12 @@ boost_python_lib_dir     = [ '/usr/lib64' ]
 # Name of the Boost Python library in boost_python_lib_dir.
 # boost_python_lib         = [ 'boost_python-mt' ]
 boost_python_lib         = [ 'boost_python' ]
+#
+# Should the instrumentation counters be compiled in (True or False)
+instrument               = False
+#
+# Does your version of CppAD support f.optimize(options) (True or False)
+optimize_options         = False
 # END USER SETTINGS
 # ---------------------------------------------------------------------
 # See http://docs.python.org/distutils/setupscript.html
@@ -60,8 +66,24 @@ cppad_extension_include_dirs  += boost_python_include_dir
 remove_duplicates(cppad_extension_include_dirs)
 cppad_extension_library_dirs   = boost_python_lib_dir
 cppad_extension_libraries      = boost_python_lib
+cppad_extension_define_macros  = []
+if instrument :
+	cppad_extension_define_macros.append( ('PYCPPAD_INSTRUMENT', None) )
+if optimize_options :
+	cppad_extension_define_macros.append( ('PYCPPAD_OPTIMIZE_OPTIONS', None) )
 #
-file_list = [ 'adfun.cpp', 'pycppad.cpp', 'vec2array.cpp', 'vector.cpp' ]
+file_list = [ 
+	'adfun.cpp', 
+	'atomic.cpp', 
+	'freelist.cpp', 
+	'instrument.cpp', 
+	'memory.cpp', 
+	'op_count.cpp', 
+	'pycppad.cpp', 
+	'threads.cpp', 
+	'vec2array.cpp', 
+	'vector.cpp' 
+]
 cppad_extension_sources = [ os.path.join('pycppad', f) for f in file_list ]
 extension_modules = [ Extension( 
 	cppad_extension_name                        , 
@@ -69,6 +91,7 @@ extension_modules = [ Extension(
 	include_dirs = cppad_extension_include_dirs ,
 	library_dirs = cppad_extension_library_dirs ,
 	libraries    = cppad_extension_libraries    ,
+	define_macros = cppad_extension_define_macros ,
 ) ]
 #
 brad_email        = 'bradbell @ seanet dot com'
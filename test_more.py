@@ -568,6 +568,311 @@ def pycppad_test_mixed_element_types():
 	assert ok
 	#
 
+def pycppad_test_independent_element_types():
+	ok  = False
+	try :
+		a_x = independent( [ 1. , 2. ] )
+	except NotImplementedError :
+		ok  = True
+	assert ok
+	# float32, int and object arrays all give a_float independent variables
+	for x in [
+		numpy.array( [ 1. , 2. ], dtype=numpy.float32 ) ,
+		numpy.array( [ 1 , 2 ] )                         ,
+		numpy.array( [ 1. , 2. ], dtype=object )         ,
+		numpy.array( [ 1. , 0. , 2. ] )[::2]             ] :
+		a_x = independent(x)
+		assert isinstance(a_x[0], a_float)
+		assert a_x[1] == 2.
+		f   = adfun(a_x, a_x)
+		assert isinstance(f, adfun_float)
+	# level two independent variables with mixed types
+	a_x = ad( numpy.array( [ 1. , 2. ] ) )
+	a_x = numpy.array( [ a_x[0], 2. ], dtype=object )
+	ok  = False
+	try :
+		a2x = independent(a_x)
+	except NotImplementedError :
+		ok  = True
+	assert ok
+
+def pycppad_test_ad_value_array():
+	# shape, element types and level are preserved by ad and value
+	x   = numpy.array( [ [ 1. , 2. , 3. ] , [ 4. , 5. , 6. ] ] ).T
+	a_x = ad(x)
+	assert a_x.shape == (3, 2)
+	assert isinstance(a_x[1, 1], a_float) and a_x[1, 1] == 5.
+	a2x = ad(a_x)
+	assert isinstance(a2x[2, 0], a2float) and a2x[2, 0] == 3.
+	assert isinstance( ad( numpy.array( [ 1 , 2 ] ) )[1], a_float )
+	y   = value(a_x)
+	assert y.dtype == numpy.float64 and y.shape == (3, 2)
+	assert numpy.all( y == x )
+	a_y = value(a2x)
+	assert isinstance(a_y[0, 1], a_float) and a_y[0, 1] == 4.
+	# mixed levels in value give an object array
+	z   = value( numpy.array( [ a_x[0, 0] , a2x[0, 0] ] ) )
+	assert isinstance(z[0], float) and isinstance(z[1], a_float)
+	ok  = False
+	try :
+		value( numpy.array( [ 1. , 2. ] ) )
+	except NotImplementedError :
+		ok  = True
+	assert ok
+
+def pycppad_test_freelist():
+	# freed a_float and a2float objects are held for reuse
+	release_memory()
+	a_x = independent( numpy.array( [ 1. , 2. ] ) )
+	a_y = a_x[0]
+	for i in range(100) :
+		a_y = a_y / a_x[1] + 1.
+	f   = adfun(a_x, numpy.array( [ a_y ] ))
+	assert memory()['freelist'] > 0
+	# reused objects behave as new ones
+	a_z = ad(3.) / 2.
+	assert isinstance(a_z, a_float) and a_z == 1.5
+	a2z = ad( ad(3.) ) * 2.
+	assert isinstance(a2z, a2float) and a2z == 6.
+	assert release_memory() > 0
+	assert memory()['freelist'] == 0
+
+def pycppad_test_linear_operator_after_optimize():
+	# optimize at construction, pin an operator, then optimize again
+	delta = 10. * numpy.finfo(float).eps
+	a_x   = independent( numpy.array( [ 0. , 0. ] ) )
+	a_y   = numpy.array( [ a_x[0] * a_x[1] , a_x[0] + a_x[1] ] )
+	f     = adfun(a_x, a_y, optimize = True)
+	x     = numpy.array( [ 2. , 3. ] )
+	A     = f.linear_operator(x)
+	f.optimize()
+	jv    = A.matvec( numpy.array( [ 1. , 0. ] ) )
+	assert abs( jv[0] - 3. ) < delta and abs( jv[1] - 1. ) < delta
+	uj    = A.rmatvec( numpy.array( [ 1. , 0. ] ) )
+	assert abs( uj[0] - 3. ) < delta and abs( uj[1] - 2. ) < delta
+
+def pycppad_test_reduce_float_operands():
+	# level zero operands give the numpy result and record nothing
+	x = numpy.array( [ 1. , 2. , 3. ] )
+	w = [ 4 , 5. , 6 ]
+	s = reduce_dot(w, x)
+	assert isinstance(s, float)
+	assert s == numpy.dot(w, x)
+	assert reduce_sum(x) == 6.
+	assert reduce_sumsq(x) == 14.
+	assert reduce_dot( numpy.array( [ 1. , 2. ], dtype=object ), x[0:2] ) == 5.
+	# mixed levels are still an error
+	a_x  = ad(x)
+	a2x  = ad(a_x)
+	ok   = False
+	try :
+		reduce_dot(a_x, a2x)
+	except NotImplementedError :
+		ok = True
+	assert ok
+
+def pycppad_test_derivative_adfun_order():
+	x   = numpy.array( [ 1. , 2. ] )
+	a_x = independent(x)
+	a_y = numpy.array( [ a_x[0] * exp( a_x[1] ) ] )
+	f   = adfun(a_x, a_y)
+	# orders that are not supported raise NotImplementedError
+	J   = f.derivative_adfun('jacobian')
+	h   = f.derivative_adfun('hessian_vector')
+	g   = f.derivative_adfun('gradient')
+	x2  = numpy.concatenate( (x, x) )
+	for call in [
+		lambda : J.jacobian(x)                               ,
+		lambda : h.jacobian(x2)                              ,
+		lambda : g.hessian(x, numpy.array( [ 1. , 0. ] ) )   ] :
+		ok = False
+		try :
+			call()
+		except NotImplementedError :
+			ok = True
+		assert ok
+	# zero order still works after the error
+	y   = J.forward(0, x)
+	assert abs( y[0] - exp( x[1] ) ) < 1e-10
+	# an unknown kind is a ValueError
+	ok  = False
+	try :
+		f.derivative_adfun('hessian')
+	except ValueError :
+		ok = True
+	assert ok
+
+def pycppad_test_recording_threads_busy():
+	import threading
+	recording_threads(2)
+	started = threading.Event()
+	resume  = threading.Event()
+	def record_wait() :
+		a_x = independent( numpy.array( [ 1. ] ) )
+		started.set()
+		resume.wait()
+		abort_recording()
+	thread = threading.Thread(target = record_wait)
+	thread.start()
+	started.wait()
+	# the main thread uses the other thread number
+	a_x = independent( numpy.array( [ 2. ] ) )
+	# a third thread can not record while both numbers are recording
+	result = dict()
+	def record_busy() :
+		try :
+			independent( numpy.array( [ 3. ] ) )
+			result['ok'] = False
+		except ValueError :
+			result['ok'] = True
+	busy = threading.Thread(target = record_busy)
+	busy.start()
+	busy.join()
+	assert result['ok']
+	# the number is released when the main thread recording stops
+	f   = adfun(a_x, a_x)
+	def record_free() :
+		a_x = independent( numpy.array( [ 3. ] ) )
+		g   = adfun(a_x, a_x * a_x)
+		result['y'] = g.forward(0, numpy.array( [ 4. ] ) )[0]
+	free = threading.Thread(target = record_free)
+	free.start()
+	free.join()
+	assert result['y'] == 16.
+	resume.set()
+	thread.join()
+	recording_threads(1)
+
+def pycppad_test_value_and_grad_errors():
+	x   = numpy.array( [ 1. , 2. ] )
+	a_x = independent(x)
+	f   = adfun(a_x, a_x * a_x)
+	# value_and_grad requires a range of size one
+	ok  = False
+	try :
+		f.value_and_grad(x)
+	except ValueError :
+		ok = True
+	assert ok
+	# w must have the range size
+	ok  = False
+	try :
+		f.value_jac_hess(x, numpy.array( [ 1. ] ) )
+	except ValueError :
+		ok = True
+	assert ok
+
+def pycppad_test_hessian_vector_errors():
+	x   = numpy.array( [ 1. , 2. ] )
+	a_x = independent(x)
+	f   = adfun(a_x, numpy.array( [ a_x[0] * a_x[1] ] ) )
+	w   = numpy.array( [ 1. ] )
+	for (w, v) in [
+		( numpy.array( [ 1. , 1. ] ) , numpy.array( [ 1. , 0. ] ) )  ,
+		( w , numpy.array( [ 1. , 0. , 0. ] ) )                      ,
+		( w , numpy.ones( (2, 2, 2) ) )                              ] :
+		ok = False
+		try :
+			f.hessian_vector(x, w, v)
+		except ValueError :
+			ok = True
+		assert ok
+	# the object is still usable after an error
+	h   = f.hessian_vector(x, w, numpy.array( [ 1. , 0. ] ) )
+	assert h[0] == 0. and h[1] == 1.
+
+def pycppad_test_hessian_diagonal_errors():
+	x   = numpy.array( [ 1. , 2. ] )
+	a_x = independent(x)
+	f   = adfun(a_x, numpy.array( [ a_x[0] * a_x[0] * a_x[1] ] ) )
+	ok  = False
+	try :
+		f.hessian_diagonal(x, numpy.array( [ 1. , 1. ] ) )
+	except ValueError :
+		ok = True
+	assert ok
+	d   = f.hessian_diagonal(x, numpy.array( [ 1. ] ) )
+	assert d[0] == 2. * x[1] and d[1] == 0.
+
+def pycppad_test_capacity_errors():
+	x   = numpy.array( [ 1. ] )
+	a_x = independent(x)
+	f   = adfun(a_x, a_x)
+	for call in [
+		lambda : f.capacity_order(-1)          ,
+		lambda : f.capacity_policy(True, 0)    ] :
+		ok = False
+		try :
+			call()
+		except ValueError :
+			ok = True
+		assert ok
+
+def pycppad_test_forward_points_errors():
+	x   = numpy.array( [ 1. , 2. ] )
+	a_x = independent(x)
+	f   = adfun(a_x, numpy.array( [ a_x[0] + a_x[1] ] ) )
+	for X in [ numpy.ones( (3, 3) ) , numpy.ones(2) ] :
+		ok = False
+		try :
+			f.forward_points(X)
+		except ValueError :
+			ok = True
+		assert ok
+	# zero points
+	Y   = f.forward_points( numpy.ones( (0, 2) ) )
+	assert Y.shape == (0, 1)
+
+def pycppad_test_vector_op_errors():
+	a_x = ad( numpy.array( [ 1. , 2. , 3. ] ) )
+	for call in [
+		lambda : vadd( a_x, numpy.array( [ 1. , 2. ] ) )      ,
+		lambda : vmul( a_x, numpy.ones( (3, 1) ) )             ,
+		lambda : vdot( numpy.ones( (2, 2) ), a_x )             ] :
+		ok = False
+		try :
+			call()
+		except ValueError :
+			ok = True
+		assert ok
+	# operations without an AD operand are not implemented
+	ok  = False
+	try :
+		vsin( numpy.array( [ 1. , 2. ] ) )
+	except NotImplementedError :
+		ok = True
+	assert ok
+	# an operand with one element is used with every element
+	a_y = vadd(a_x, 1.)
+	assert a_y[2] == 4.
+
+def pycppad_test_condexp_array_errors():
+	a_x = ad( numpy.array( [ 1. , 2. , 3. ] ) )
+	ok  = False
+	try :
+		condexp_lt(a_x, numpy.array( [ 0. , 0. ] ), a_x, 0.)
+	except ValueError :
+		ok = True
+	assert ok
+	a_y = condexp_lt(a_x, 2., a_x, 0.)
+	assert a_y[0] == 1. and a_y[1] == 0. and a_y[2] == 0.
+
+def pycppad_test_linear_algebra_errors():
+	a_A = ad( numpy.array( [ [ 2. , 1. , 0. ] , [ 1. , 2. , 0. ] ] ) )
+	b   = numpy.array( [ 1. , 2. ] )
+	for call in [
+		lambda : matmul(a_A, b)                               ,
+		lambda : matmul(a_A, numpy.ones( (2, 2, 2) ) )        ,
+		lambda : lu_solve(a_A, b)                             ,
+		lambda : cholesky_solve(a_A, b)                       ,
+		lambda : lu_solve(a_A[:, 0:2], numpy.ones(3) )        ] :
+		ok = False
+		try :
+			call()
+		except ValueError :
+			ok = True
+		assert ok
+
 import sys
 if __name__ == "__main__" :
   import sys
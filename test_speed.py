@@ -0,0 +1,201 @@
+#!/usr/bin/env python
+# Speed tests for pycppad; see Speed in omh/install.omh.
+from pycppad import *
+import json
+import os
+import sys
+import time
+import platform
+# ---------------------------------------------------------------------------
+# minimum number of seconds for one timing
+min_seconds = 0.05
+# number of timings (the fastest is reported)
+n_timing    = 3
+# sizes for each problem
+size_list   = [ 10 , 50 , 200 ]
+# ---------------------------------------------------------------------------
+def seconds_per_call(call) :
+  best = None
+  for t in range(n_timing) :
+    repeat  = 1
+    seconds = 0.
+    while seconds < min_seconds :
+      start = time.time()
+      for r in range(repeat) :
+        call()
+      seconds = time.time() - start
+      repeat  = 2 * repeat
+    seconds = seconds / (repeat / 2)
+    if best is None or seconds < best :
+      best = seconds
+  return best
+# ---------------------------------------------------------------------------
+# Each problem takes a_x, an independent variable vector of length size,
+# and returns the dependent variable vector.
+#
+# dense polynomial: every pair of domain components is multiplied
+def polynomial(a_x) :
+  n     = len(a_x)
+  a_sum = 0.
+  for i in range(n) :
+    a_row = 0.
+    for j in range(n) :
+      a_row = a_row + (i + j + 1.) * a_x[j]
+    a_sum = a_sum + a_x[i] * a_row * a_row
+  return numpy.array( [ a_sum ] )
+#
+# ordinary differential equation: y'(t) = - x * y(t), y(0) = 1
+def ode(a_x) :
+  n_step = 10
+  dt     = 1. / n_step
+  def fun(t, y) :
+    return - a_x * y
+  a_y = numpy.array( len(a_x) * [ ad(1.) ] )
+  for k in range(n_step) :
+    a_y = runge_kutta_4(fun, k * dt, a_y, dt)
+  return a_y
+#
+# sparse banded residual: discrete Laplacian plus an exponential term
+def banded(a_x) :
+  n   = len(a_x)
+  a_r = list()
+  for i in range(n) :
+    a_ri = - 2. * a_x[i] + exp( a_x[i] )
+    if i > 0 :
+      a_ri = a_ri + a_x[i-1]
+    if i < n - 1 :
+      a_ri = a_ri + a_x[i+1]
+    a_r.append(a_ri)
+  return numpy.array(a_r)
+#
+# wide neural layer: tanh(W x + b) with constant weights
+def neural(a_x) :
+  n   = len(a_x)
+  a_y = list()
+  for i in range(n) :
+    a_z = 0.1 * i
+    for j in range(n) :
+      a_z = a_z + ( ( (i * n + j) % 7 ) - 3. ) / n * a_x[j]
+    a_y.append( tanh(a_z) )
+  return numpy.array(a_y)
+#
+problem_list = [
+  ('polynomial', polynomial) ,
+  ('ode',        ode)        ,
+  ('banded',     banded)     ,
+  ('neural',     neural)
+]
+# ---------------------------------------------------------------------------
+def time_problem(name, problem, size, result) :
+  x   = numpy.array( [ 0.5 + j / (2. * size) for j in range(size) ] )
+  def record() :
+    a_x = independent(x)
+    a_y = problem(a_x)
+    return adfun(a_x, a_y)
+  key = name + '/' + str(size) + '/'
+  result[key + 'record'] = seconds_per_call(record)
+  #
+  def record_optimize() :
+    record().optimize()
+  result[key + 'optimize'] = seconds_per_call(record_optimize) - \
+    result[key + 'record']
+  #
+  f   = record()
+  f.optimize()
+  m   = f.range()
+  x1  = numpy.ones(size)
+  w   = numpy.ones(m)
+  f.forward(0, x)
+  result[key + 'forward_0'] = seconds_per_call( lambda : f.forward(0, x) )
+  result[key + 'forward_1'] = seconds_per_call( lambda : f.forward(1, x1) )
+  result[key + 'reverse_1'] = seconds_per_call( lambda : f.reverse(1, w) )
+  result[key + 'jacobian']  = seconds_per_call( lambda : f.jacobian(x) )
+  result[key + 'hessian']   = seconds_per_call( lambda : f.hessian(x, w) )
+#
+# Conversion between numpy arrays and pycppad vectors (vec, vec2array)
+# dominates forward(0, x) when f is the identity function.
+def time_conversion(size, result) :
+  key = 'conversion/' + str(size) + '/'
+  x   = numpy.ones(size)
+  a_x = independent(x)
+  f   = adfun(a_x, a_x)
+  result[key + 'float']   = seconds_per_call( lambda : f.forward(0, x) )
+  #
+  a_x = ad(x)
+  a_u = independent(a_x)
+  g   = adfun(a_u, a_u)
+  result[key + 'a_float'] = seconds_per_call( lambda : g.forward(0, a_x) )
+  #
+  result[key + 'ad']      = seconds_per_call( lambda : ad(x) )
+  result[key + 'value']   = seconds_per_call( lambda : value(a_x) )
+#
+# forward_points is a C++ loop of zero order sweeps; compare it with
+# the python loop of forward(0, x) calls that it replaces.
+def time_forward_points(n_point, result) :
+  key = 'forward_points/' + str(n_point) + '/'
+  n   = 10
+  x   = numpy.array( [ 0.5 + j / (2. * n) for j in range(n) ] )
+  a_x = independent(x)
+  f   = adfun(a_x, banded(a_x))
+  X   = numpy.array( n_point * [ x ] )
+  def python_loop() :
+    for i in range(n_point) :
+      f.forward(0, X[i])
+  result[key + 'python_loop'] = seconds_per_call(python_loop)
+  result[key + 'c_loop']      = seconds_per_call( lambda : f.forward_points(X) )
+# ---------------------------------------------------------------------------
+def compare(result, baseline, tolerance) :
+  number_slower = 0
+  for key in sorted( result.keys() ) :
+    if key in baseline and baseline[key] > 0. :
+      ratio = result[key] / baseline[key]
+      if ratio > tolerance :
+        print 'Slower: %-30s %8.2f times baseline' % (key, ratio)
+        number_slower = number_slower + 1
+  return number_slower
+# ---------------------------------------------------------------------------
+if __name__ == "__main__" :
+  if len(sys.argv) < 2 or len(sys.argv) > 4 :
+    print 'usage: python test_speed.py output [baseline [tolerance]]'
+    print '       output:    json file where the results are written'
+    print '       baseline:  json file from a previous run to compare with'
+    print '       tolerance: ratio to baseline that is reported (default 1.25)'
+    sys.exit(1)
+  output_file = sys.argv[1]
+  baseline    = None
+  tolerance   = 1.25
+  if len(sys.argv) >= 3 :
+    baseline = json.load( open(sys.argv[2], 'r') )['seconds']
+  if len(sys.argv) == 4 :
+    tolerance = float( sys.argv[3] )
+  #
+  result = dict()
+  for (name, problem) in problem_list :
+    for size in size_list :
+      time_problem(name, problem, size, result)
+      print 'Done:  %s/%d' % (name, size)
+  for size in [ 100 , 10000 ] :
+    time_conversion(size, result)
+  print 'Done:  conversion'
+  for n_point in [ 10 , 1000 ] :
+    time_forward_points(n_point, result)
+  print 'Done:  forward_points'
+  #
+  output = {
+    'python'   : platform.python_version() ,
+    'machine'  : platform.machine()        ,
+    'seconds'  : result
+  }
+  json.dump(output, open(output_file, 'w'), indent = 1, sort_keys = True)
+  print 'Wrote %d timings to %s' % (len(result), output_file)
+  #
+  if baseline is not None :
+    number_slower = compare(result, baseline, tolerance)
+    if number_slower == 0 :
+      print 'All timings within %g times baseline' % tolerance
+      sys.exit(0)
+    else :
+      print '%d timings slower than %g times baseline' % \
+        (number_slower, tolerance)
+      sys.exit(1)
+  sys.exit(0)